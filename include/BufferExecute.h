@@ -1,13 +1,15 @@
 #pragma once
 #include <Arduino.h>
 
-extern void loopCmdAdd(const String& cmdStr);
+#include "Class/EventQueue.h"
+
+extern bool loopCmdAdd(const String& cmdStr, uint8_t source = ES_LOCAL);
+extern bool orderAdd(const String& list, uint8_t source);
 extern void fileCmdExecute(const String& filename);
 extern void csvCmdExecute(String& cmdStr);
-extern void spaceCmdExecute(String& cmdStr);
+extern void spaceCmdExecute(const String& cmdStr);
 extern void loopCmdExecute();
-extern void addKey(String& key, String& keyNumberTable, int number);
-extern int getKeyNum(String& key, String& keyNumberTable);
+extern String getQueueStatsJson(const String& json);
 
 extern void buttonIn();
 extern void buttonInSet();
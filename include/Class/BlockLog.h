@@ -0,0 +1,57 @@
+#pragma once
+#include <Arduino.h>
+
+#include "Class/Gorilla.h"
+#include "Class/RingLog.h"
+#include "FileSystem.h"
+
+#define BLOCK_LOG_MAGIC 0x31474C42UL  //"BLG1"
+#define BLOCK_LOG_TMP_FILE "/block.tmp"
+
+struct BlockLogHeader {
+    uint32_t magic;
+    uint16_t blockSize;
+    uint16_t blocks;
+    uint16_t head;  //блок, который сейчас заполняется
+    uint16_t used;  //блоков с данными, включая текущий
+};
+
+/*
+* Кольцо сжатых блоков GorillaBlock в файле постоянного размера
+* Места на флеше столько же, сколько у RingLog на то же число точек,
+* а точек помещается в несколько раз больше. Текущий блок держится в памяти,
+* при добавлении точки пишутся только изменившиеся байты и заголовок
+*/
+class BlockLog {
+   public:
+    BlockLog(const String& path, size_t maxPoints);
+
+    bool append(uint32_t time, float value);
+    void forEach(RingLogHandler_t handler, size_t start = 0, size_t limit = SIZE_MAX);
+    bool importText(const String& filename);
+    uint32_t oldestTime();  //время первой точки, 0 - пусто
+
+    size_t count() const {
+        return _points;
+    }
+    const String& path() const {
+        return _path;
+    }
+
+   private:
+    bool open();
+    bool create(uint16_t blocks);
+    bool resize(uint16_t blocks);
+    uint16_t blockCount(File& file, uint16_t block);
+    bool appendTo(File& file, uint32_t time, float value);
+
+    size_t blockOffset(uint16_t block) const {
+        return sizeof(BlockLogHeader) + (size_t)block * LOG_BLOCK_SIZE;
+    }
+
+    String _path;
+    BlockLogHeader _hdr;
+    GorillaBlock _current;
+    uint32_t _points;
+    size_t _written;  //байт текущего блока, точно записанных в файл
+};
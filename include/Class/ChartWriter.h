@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+
+#include <functional>
+#include <vector>
+
+#include "Class/RingLog.h"
+#include "Consts.h"
+
+#define CHART_POINT_MAX 72  //,{"x":4294967295,"y1":-3.4e38 с двумя знаками}
+
+typedef std::function<void(const char* data, size_t length)> ChartFlush_t;
+
+/*
+* Потоковая сборка точек графика {"status":[{"x":..,"y1":..},..]} в буфер фиксированного размера
+* Когда буфер заполнен или набрано maxPoints точек, пачка отдается в flush и начинается следующая
+* Без разбора json и без выделения памяти на каждую точку
+*/
+class ChartWriter {
+   public:
+    ChartWriter(size_t maxPoints, ChartFlush_t flush);
+
+    void add(uint32_t time, float value);
+    void finish();  //отдать остаток, пустая пачка тоже отдается
+
+    static size_t formatPoint(char* buf, size_t size, uint32_t time, float value, bool first);
+
+   private:
+    void open();
+    void send();
+
+    char _buf[CHART_CHUNK_SIZE];
+    size_t _len;
+    size_t _points;
+    size_t _maxPoints;
+    ChartFlush_t _flush;
+};
+
+/*
+* То же в обратную сторону - для ответа AsyncWebServer по частям:
+* fill() дописывает в буфер сколько влезет, 0 - все отдано
+*/
+class ChartFiller {
+   public:
+    explicit ChartFiller(std::vector<RingLogRecord>& points);
+
+    size_t fill(uint8_t* buf, size_t maxLen);
+
+   private:
+    bool nextPiece();
+
+    std::vector<RingLogRecord> _points;
+    size_t _next;
+    uint8_t _stage;  //0 - начало, 1 - точки, 2 - конец, 3 - все
+    char _piece[CHART_POINT_MAX];
+    size_t _pieceLen;
+    size_t _piecePos;
+};
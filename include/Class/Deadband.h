@@ -0,0 +1,54 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+
+#include <vector>
+
+/*
+* Отчет по исключению для датчиков: параметры db[], minint[], maxint[] строки конфигурации
+* db[]     - значение отправляется, только если ушло от последнего отправленного больше чем на db
+* minint[] - не чаще одного раза в minint секунд
+* maxint[] - не реже одного раза в maxint секунд, даже если значение не менялось
+* Ключи без этих параметров не фильтруются
+* Используется только из loop
+*/
+class Deadband {
+   public:
+    void add(const String& key, const String& db, const String& minint, const String& maxint);
+    bool pass(const String& key, float value);
+    void clear();
+
+    size_t size() const {
+        return _filters.size();
+    }
+    const String& key(size_t i) const {
+        return _filters[i].key;
+    }
+    uint32_t suppressed(size_t i) const {
+        return _filters[i].suppressed;
+    }
+    void statsToJson(JsonObject& root) const;
+
+    uint32_t _passed = 0;
+    uint32_t _suppressed = 0;
+
+   private:
+    struct Filter {
+        String key;
+        float db;
+        uint32_t minInt_ms;
+        uint32_t maxInt_ms;
+        bool reported;
+        float last;
+        unsigned long lastReport;
+        uint32_t suppressed;
+    };
+
+    std::vector<Filter> _filters;
+};
+
+extern Deadband deadband;
+
+//значение датчика: в liveValues всегда, событие и mqtt - только если прошло фильтр
+extern void sensorReport(const String& key, float value);
@@ -0,0 +1,45 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "Class/EventQueue.h"
+
+/*
+* Очередь последних значений событий: одна запись на ключ
+* Новое значение для ключа, который еще ждет разбора, заменяет старое,
+* поэтому длина очереди ограничена числом ключей, а не частотой опроса датчиков
+* Используется только из loop
+*/
+class EventCoalescer {
+   public:
+    void add(uint16_t keyId, const String& value);
+    bool pop(QueueRecord& rec);
+    void clear();  //перед сменой таблицы ключей: ожидающие значения уходят в eventQueue по имени
+
+    size_t depth() const {
+        return _count;
+    }
+    void statsToJson(JsonObject& root) const;
+
+    uint32_t _coalesced = 0;  //значений замещено более новыми
+    uint32_t _processed = 0;
+
+   private:
+    void grow(size_t size);
+
+    struct Slot {
+        bool pending = false;
+        unsigned long stamp;
+        String value;
+    };
+
+    std::vector<Slot> _slots;       //по номеру ключа в keyTable
+    std::vector<uint16_t> _order;  //кольцо номеров ключей в порядке поступления
+    size_t _head = 0;
+    size_t _count = 0;
+};
+
+extern EventCoalescer eventCoalescer;
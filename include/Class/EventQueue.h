@@ -0,0 +1,81 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+
+#include "Consts.h"
+#include "Utils/QueueStats.h"
+
+//откуда пришло событие или команда
+enum EventSource_t {
+    ES_LOCAL,
+    ES_WEB,
+    ES_MQTT,
+    ES_UDP,
+    ES_UART,
+    ES_TELEGRAM,
+    ES_MYSENSORS
+};
+
+//что делать при переполнении очереди
+enum QueueDrop_t {
+    QD_NEWEST,  //отбросить новую запись
+    QD_OLDEST   //вытеснить самую старую
+};
+
+struct QueueRecord {
+    uint16_t keyId;  //номер в keyTable, из EventQueue всегда KEY_UNKNOWN
+    uint8_t source;
+    unsigned long stamp;
+    String key;
+    String value;
+};
+
+/*
+* Ограниченная очередь записей без блокировок (схема Вьюкова, на каждую ячейку свой счетчик)
+* Писать можно из любого контекста кроме прерываний: loop, AsyncWebServer, AsyncUDP, mqtt callback
+* Читает только loop
+* Емкость - степень двойки, ключ и значение любой длины лежат в куче и освобождаются при разборе
+* push() возвращает false, если запись не принята (очередь полна или нет памяти)
+*/
+class EventQueue {
+   public:
+    EventQueue(size_t capacity, QueueDrop_t policy);
+    ~EventQueue();
+
+    bool push(const char* key, size_t keyLen, const char* value, size_t valueLen, uint8_t source);
+    bool push(const String& key, const String& value, uint8_t source);
+    size_t pushList(const String& list, uint8_t source, size_t* lost = nullptr);
+    bool pop(QueueRecord& rec);
+
+    size_t depth() const;
+    bool empty() const {
+        return !depth();
+    }
+    void statsToJson(JsonObject& root, const String& prefix) const;
+
+    QueueStats stats;
+
+   private:
+    struct Cell {
+        volatile uint32_t seq;
+        uint8_t source;
+        unsigned long stamp;
+        char* data;  //ключ и значение подряд, каждое с нулем в конце
+        size_t keyLen;
+    };
+
+    bool take(QueueRecord* rec);  //nullptr - просто выбросить запись
+
+    Cell* _cells;
+    uint32_t _mask;
+    QueueDrop_t _policy;
+    volatile uint32_t _enqueuePos;
+    volatile uint32_t _dequeuePos;
+};
+
+extern EventQueue eventQueue;
+extern EventQueue orderQueue;
+#ifdef MYSENSORS
+extern EventQueue mysensorQueue;
+#endif
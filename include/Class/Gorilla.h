@@ -0,0 +1,78 @@
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "Consts.h"
+
+#define GORILLA_HEADER_SIZE 12  //время, значение первой точки, число точек, занято бит
+
+/*
+* Блок точек графика, сжатых как в Gorilla (Facebook):
+* время - разность разностей переменной длины, значение - xor с предыдущим,
+* пишутся только значащие биты. Блок фиксированного размера декодируется независимо
+*/
+class GorillaBlock {
+   public:
+    GorillaBlock();  //пустой блок: count() == 0, первый append() начнет его
+
+    void begin(uint32_t time, float value);
+    bool append(uint32_t time, float value);  //false - не поместилось, блок не изменился
+    bool resume();                            //восстановить состояние кодера по содержимому буфера
+
+    uint16_t count() const {
+        return _count;
+    }
+    size_t used() const {
+        return (_bitPos + 7) / 8;
+    }
+    uint8_t* data() {
+        return _buf;
+    }
+    const uint8_t* data() const {
+        return _buf;
+    }
+
+   private:
+    friend class GorillaDecoder;
+
+    bool writeBits(uint32_t value, uint8_t bits);
+    void writeHeader();
+
+    uint8_t _buf[LOG_BLOCK_SIZE];
+    uint32_t _bitPos;
+    uint32_t _prevTime;
+    int32_t _prevDelta;
+    uint32_t _prevValue;
+    uint8_t _leading;
+    uint8_t _trailing;
+    uint16_t _count;
+};
+
+/*
+* Потоковое чтение точек из блока
+*/
+class GorillaDecoder {
+   public:
+    GorillaDecoder(const uint8_t* buf, size_t size);
+
+    bool next(uint32_t& time, float& value);
+    void saveState(GorillaBlock& block) const;
+
+    uint16_t count() const {
+        return _count;
+    }
+
+   private:
+    bool readBits(uint32_t& value, uint8_t bits);
+
+    const uint8_t* _buf;
+    size_t _size;
+    uint32_t _bitPos;
+    uint32_t _prevTime;
+    int32_t _prevDelta;
+    uint32_t _prevValue;
+    uint8_t _leading;
+    uint8_t _trailing;
+    uint16_t _count;
+    uint16_t _read;
+};
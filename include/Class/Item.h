@@ -0,0 +1,22 @@
+#pragma once
+#include <Arduino.h>
+
+#define ITEM_PASSIVE 0xFFFFFFFF
+
+/*
+* Общий интерфейс элементов конфигурации, которые работают в loop
+* interval() - через сколько мс планировщик снова вызовет loop(),
+* 0 - на каждом проходе, ITEM_PASSIVE - не вызывать
+*/
+class Item {
+   public:
+    virtual ~Item() {}
+
+    virtual void loop() = 0;
+
+    virtual unsigned long interval() const {
+        return 0;
+    }
+
+    virtual const String& itemKey() const = 0;
+};
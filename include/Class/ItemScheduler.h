@@ -0,0 +1,71 @@
+#pragma once
+#include <Arduino.h>
+
+#include <vector>
+
+#include "Class/Item.h"
+
+#define ITEM_STATS_INTERVAL 10000
+#define ITEM_STAGGER_MS 97  //шаг разнесения первых запусков, чтобы элементы с одним интервалом не срабатывали разом
+
+/*
+* Планировщик элементов: периодические элементы лежат в куче по сроку
+* следующего запуска, и loop() будит только те, у которых срок наступил
+* Элемент хранится как вектор + номер в нем, а не как адрес: push_back в вектор
+* может переложить элементы в памяти. Новые элементы в наблюдаемых векторах
+* подхватываются в loop() сами
+* Время выполнения loop() каждого элемента копится в статистике
+*/
+class ItemScheduler {
+   public:
+    template <typename T>
+    void watch(std::vector<T>* vector) {
+        addList(vector, [](void* list) -> size_t { return ((std::vector<T>*)list)->size(); },
+                [](void* list, size_t index) -> Item* { return &((std::vector<T>*)list)->at(index); });
+    }
+    void clear();
+    void loop();
+
+    const String& getStatsJson() const {
+        return _statsJson;
+    }
+
+   private:
+    typedef size_t (*ListSize_t)(void* list);
+    typedef Item* (*ListItem_t)(void* list, size_t index);
+
+    struct List {
+        void* vector;
+        ListSize_t size;
+        ListItem_t item;
+        size_t known;  //сколько элементов уже в расписании
+    };
+
+    struct Entry {
+        uint16_t list;
+        uint16_t index;
+        unsigned long deadline;
+        uint32_t runs;
+        uint32_t totalMu;
+        uint32_t maxMu;
+    };
+
+    static bool later(const Entry& a, const Entry& b);
+    void addList(void* vector, ListSize_t size, ListItem_t item);
+    void sync();
+    void drop(uint16_t list);
+    Item* item(const Entry& entry) const {
+        const List& list = _lists[entry.list];
+        return list.item(list.vector, entry.index);
+    }
+    void run(Entry& entry);
+    void updateStats();
+
+    std::vector<List> _lists;
+    std::vector<Entry> _heap;    //периодические, на вершине ближайший срок
+    std::vector<Entry> _polled;  //вызываются на каждом проходе
+    unsigned long _statsMillis = 0;
+    String _statsJson = "{}";
+};
+
+extern ItemScheduler itemScheduler;
@@ -0,0 +1,53 @@
+#pragma once
+#include <Arduino.h>
+
+#include <unordered_map>
+#include <vector>
+
+//FNV-1a хеш для ключей String
+struct StringHash {
+    size_t operator()(const String& str) const {
+        uint32_t hash = 2166136261UL;
+        for (size_t i = 0; i < str.length(); i++) {
+            hash ^= (uint8_t)str.charAt(i);
+            hash *= 16777619UL;
+        }
+        return hash;
+    }
+};
+
+/*
+* Вектор элементов с индексом ключ -> элемент
+* Поиск элемента по ключу при выполнении команды не зависит от числа элементов
+*/
+template <typename T>
+class ItemVector : public std::vector<T> {
+   public:
+    void add(const String& key, const T& item) {
+        _index[key] = this->size();
+        _keys.push_back(key);
+        this->push_back(item);
+    }
+
+    T* find(const String& key) {
+        auto it = _index.find(key);
+        if (it == _index.end()) {
+            return nullptr;
+        }
+        return &this->at(it->second);
+    }
+
+    const String& key(size_t i) const {
+        return _keys.at(i);
+    }
+
+    void clear() {
+        std::vector<T>::clear();
+        _keys.clear();
+        _index.clear();
+    }
+
+   private:
+    std::vector<String> _keys;
+    std::unordered_map<String, size_t, StringHash> _index;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+
+#define KEY_CHUNK_SIZE 16
+#define KEY_CHUNKS 64  //до 1024 ключей
+#define KEY_UNKNOWN 0xFFFF
+
+/*
+* Таблица ключей: ключ -> номер
+* В таблицу попадают только ключи правил сценария, при загрузке сценария она собирается заново,
+* поэтому переименованные ключи не копятся. Куски по KEY_CHUNK_SIZE после clear() используются повторно
+* Используется только из loop: номера ключей в записях очередей событий не хранятся
+*/
+class KeyTable {
+   public:
+    uint16_t find(const char* key, size_t len) const;
+    uint16_t find(const String& key) const;
+    uint16_t intern(const String& key);
+    void clear();
+
+    const String& name(uint16_t id) const {
+        return _chunks[id / KEY_CHUNK_SIZE][id % KEY_CHUNK_SIZE];
+    }
+
+    size_t size() const {
+        return __atomic_load_n(&_count, __ATOMIC_ACQUIRE);
+    }
+
+   private:
+    String* _chunks[KEY_CHUNKS] = {};
+    volatile uint32_t _count = 0;
+};
+
+extern KeyTable keyTable;
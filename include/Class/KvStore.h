@@ -0,0 +1,50 @@
+#pragma once
+#include <Arduino.h>
+
+#include <unordered_map>
+
+#include "Class/ItemVector.h"
+#include "Consts.h"
+#include "FileSystem.h"
+
+/*
+* Хранилище ключ -> значение в одном журнале на ФС
+* Каждое изменение дописывается в конец файла записью с контрольной суммой,
+* при старте журнал читается целиком и в памяти остаются последние значения.
+* Оборванная при пропадании питания запись в конце отбрасывается,
+* журнал больше KV_COMPACT_SIZE переписывается только живыми записями
+* Если запись не дописалась целиком (нет места, ошибка ФС), журнал сразу переписывается
+* из памяти, чтобы следующие записи не легли после мусора; set()/remove() возвращают false
+* и значение в памяти остается прежним
+*/
+class KvStore {
+   public:
+    void begin();
+
+    bool has(const String& key) const;
+    String get(const String& key) const;
+    int getInt(const String& key) const;
+
+    bool set(const String& key, const String& value);
+    int increment(const String& key);
+    bool remove(const String& key);
+
+    bool compact();
+
+    size_t logSize() const {
+        return _logSize;
+    }
+
+   private:
+    bool load();
+    bool append(File& file, const String& key, const String& value, bool removed);
+    bool appendLog(const String& key, const String& value, bool removed);
+    void importFile(const String& filename);
+
+    std::unordered_map<String, String, StringHash> _values;
+    size_t _logSize = 0;
+    size_t _liveSize = 0;
+    bool _torn = false;  //в конце журнала недописанная запись, пока не переписан - не дописывать
+};
+
+extern KvStore kvStore;
@@ -24,11 +24,15 @@ class LineParsing {
     String _db;
     String _type;
     String _int;
+    String _minint;
+    String _maxint;
     String _cnt;
     String _val;
     String _index;
     String _tm1;
     String _tm2;
+    String _r5m;
+    String _r1h;
 
     int pinErrors;
 
@@ -51,11 +55,15 @@ class LineParsing {
                     _db{""},
                     _type{""},
                     _int{""},
+                    _minint{""},
+                    _maxint{""},
                     _cnt{""},
                     _val{""},
                     _index{""},
                     _tm1{""},
                     _tm2{""},
+                    _r5m{""},
+                    _r1h{""},
 
                     pinErrors{0}
 
@@ -64,16 +72,14 @@ class LineParsing {
     void update() {
         //String order = sCmd.order();
         //SerialPrint("I","module","create '" + order + "'");
-        for (int i = 1; i < 12; i++) {
-            if (i == 1) _key = sCmd.next();
-            if (i == 2) _file = sCmd.next();
-            if (i == 3) _page = sCmd.next();
-            if (i == 4) _descr = sCmd.next();
-            if (i == 5) _order = sCmd.next();
-        }
+        _key = sCmd.arg(1);
+        _file = sCmd.arg(2);
+        _page = sCmd.arg(3);
+        _descr = sCmd.arg(4);
+        _order = sCmd.arg(5);
 
-        for (int i = 1; i < 10; i++) {
-            String arg = sCmd.next();
+        for (uint16_t i = 6; i < sCmd.argCount(); i++) {
+            String arg = sCmd.arg(i);
             if (arg != "") {
                 if (arg.indexOf("pin[") != -1) {
                     _pin = extractInner(arg);
@@ -105,9 +111,15 @@ class LineParsing {
                 if (arg.indexOf("reg[") != -1) {
                     _reg = extractInner(arg);
                 }
-                if (arg.indexOf("int[") != -1) {
+                if (arg.startsWith("int[")) {  //без startsWith совпадет и с minint[], maxint[]
                     _int = extractInner(arg);
                 }
+                if (arg.indexOf("minint[") != -1) {
+                    _minint = extractInner(arg);
+                }
+                if (arg.indexOf("maxint[") != -1) {
+                    _maxint = extractInner(arg);
+                }
                 if (arg.indexOf("cnt[") != -1) {
                     _cnt = extractInner(arg);
                 }
@@ -123,6 +135,12 @@ class LineParsing {
                 if (arg.indexOf("tm2[") != -1) {
                     _tm2 = extractInner(arg);
                 }
+                if (arg.indexOf("r5m[") != -1) {
+                    _r5m = extractInner(arg);
+                }
+                if (arg.indexOf("r1h[") != -1) {
+                    _r1h = extractInner(arg);
+                }
             }
         }
 
@@ -192,9 +210,18 @@ class LineParsing {
     String gregaddr() {
         return _reg;
     }
+    String gdb() {
+        return _db;
+    }
     String gint() {
         return _int;
     }
+    String gminint() {
+        return _minint;
+    }
+    String gmaxint() {
+        return _maxint;
+    }
     String gcnt() {
         return _cnt;
     }
@@ -210,6 +237,12 @@ class LineParsing {
     String gtm2() {
         return _tm2;
     }
+    String gr5m() {
+        return _r5m;
+    }
+    String gr1h() {
+        return _r1h;
+    }
 
     int getPinErrors() {
         return pinErrors;
@@ -236,9 +269,13 @@ class LineParsing {
         _db = "";
         _type = "";
         _int = "";
+        _minint = "";
+        _maxint = "";
         _cnt = "";
         _val = "";
         _index = "";
+        _r5m = "";
+        _r1h = "";
     }
 
     String extractInnerDigit(String str) {
@@ -253,18 +290,20 @@ class LineParsing {
             if (!loadWidget(filename, buf)) {
                 return;
             }
+            JsonBatch batch(buf);
             if (_cnt != "") {
-                if (filename.indexOf("chart") != -1) jsonWriteStr(buf, "maxCount", _cnt);
+                if (filename.indexOf("chart") != -1) batch.setStr("maxCount", _cnt);
             }
 
 #ifdef GATE_MODE
-            jsonWriteStr(buf, "info", " ");
+            batch.setStr("info", " ");
 #endif
 
-            jsonWriteStr(buf, "page", page);
-            jsonWriteStr(buf, "order", order);
-            jsonWriteStr(buf, "descr", descr);
-            jsonWriteStr(buf, "topic", prex + "/" + topic);
+            batch.setStr("page", page)
+                .setStr("order", order)
+                .setStr("descr", descr)
+                .setStr("topic", prex + "/" + topic);
+            batch.commit();
 
 #ifdef LAYOUT_IN_RAM
             all_widgets += widget + "\r\n";
@@ -0,0 +1,34 @@
+#pragma once
+#include <Arduino.h>
+
+#include <memory>
+#include <vector>
+
+#include "Class/ChartWriter.h"
+#include "Consts.h"
+
+/*
+* Запрос истории лога из веба: /logs/query?key=&from=&to=&points=
+* Обработчик запроса только ставит его в очередь, чтение флеша и прореживание LTTB
+* выполняются в loop (там же, где пишется лог), ответ отдается по частям, когда готов
+* Пока не готов, fill() возвращает RESPONSE_TRY_AGAIN и сервер спросит снова
+*/
+class LogQuery {
+   public:
+    LogQuery(const String& key, uint32_t from, uint32_t to, size_t points);
+
+    void run();                                  //только loop
+    size_t fill(uint8_t* buf, size_t maxLen);    //только веб
+
+   private:
+    String _key;
+    uint32_t _from;
+    uint32_t _to;
+    size_t _points;
+    std::vector<RingLogRecord> _result;
+    std::unique_ptr<ChartFiller> _filler;
+    bool _ready = false;  //только через __atomic
+};
+
+extern bool logQueryAdd(std::shared_ptr<LogQuery> query);  //false - очередь полна
+extern void logQueriesLoop();
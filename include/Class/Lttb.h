@@ -0,0 +1,22 @@
+#pragma once
+#include <Arduino.h>
+
+#include <functional>
+#include <vector>
+
+#include "Class/RingLog.h"
+
+typedef std::function<void(RingLogHandler_t)> LttbSource_t;
+
+/*
+* Прореживание ряда точек методом Largest-Triangle-Three-Buckets
+* Первая и последняя точки остаются, остальные делятся на points - 2 равных по времени
+* интервала, из каждого берется точка, дающая наибольший треугольник с уже выбранной
+* предыдущей и средним следующего интервала
+* source читается три раза, памяти нужно на points интервалов, а не на весь ряд
+* Точек в out не больше points: при points = 1 остается последняя, при points = 2 - первая и последняя
+*/
+class Lttb {
+   public:
+    static void downsample(LttbSource_t source, size_t points, std::vector<RingLogRecord>& out);
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+
+#include "Consts.h"
+
+#define MQTT_RATE_UNIT 60000UL  //один токен: пополнение идет по settings.mqttRate (в минуту) за каждую мс
+
+/*
+* Ограничение частоты исходящих mqtt сообщений корзинами токенов:
+* своя корзина на каждый класс топиков (статус, событие, график, конфигурация) и общая на устройство
+* Сообщение без токена откладывается, на топик и ключ json хранится только последнее значение,
+* отложенные отправляются из loop() по мере пополнения
+* Счетчики отложенных раз в MQTT_DIAG_INTERVAL публикуются в топик <устройство>/diag
+* Используется только из loop
+*/
+class MqttLimiter {
+   public:
+    bool take(MqttClass_t cls);   //списать токен класса и общий, без токена - учесть как задержанное
+    bool ready(MqttClass_t cls);  //токены есть, ничего не списывается
+    void charge(MqttClass_t cls);  //списать после отправки, которую отправитель сам выдерживал по ready()
+
+    bool pending(const char* topic, const char* key) const;
+    bool defer(MqttClass_t cls, const char* topic, const String& payload, bool retain, const char* key);
+    void loop();
+
+    //на время полной отправки по HELLO: она идет по ready()/charge() и не откладывается
+    void bypass(bool on) {
+        _bypass = on;
+    }
+
+    size_t depth() const {
+        return _count;
+    }
+    static const char* className(uint8_t cls);
+    void statsToJson(JsonObject& root) const;
+
+    uint32_t _throttled[MC_COUNT] = {};  //по классу, корзина которого оказалась пуста
+    uint32_t _collapsed = 0;             //отложенное заменено более новым значением
+    uint32_t _dropped = 0;               //нет места для отложенного
+    uint32_t _sent = 0;                  //отложенных отправлено
+
+   private:
+    struct Bucket {
+        uint32_t level;
+        unsigned long stamp;
+        bool started;
+    };
+
+    struct Slot {
+        String topic;
+        String payload;
+        String key;  //ключ json статуса, пусто - схлопывать по топику
+        uint8_t cls = 0;
+        bool retain = false;
+        bool used = false;
+    };
+
+    void refill(uint8_t cls);
+    bool available(uint8_t cls);
+    void consume(uint8_t cls);
+    void publishDiag();
+
+    Bucket _buckets[MC_COUNT] = {};
+    Slot _slots[MQTT_DEFER_SIZE];
+    size_t _count = 0;
+    size_t _next = 0;  //с какого места продолжать обход, чтобы никого не обходить постоянно
+    bool _bypass = false;
+    unsigned long _diagAt = 0;
+    uint32_t _diagLast = 0;
+};
+
+extern MqttLimiter mqttLimiter;
@@ -0,0 +1,74 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+
+#include "Consts.h"
+#include "FileSystem.h"
+
+#define MQTT_SPOOL_MAGIC 0x314C5053UL  //"SPL1"
+
+struct MqttSpoolHeader {
+    uint32_t magic;
+    uint32_t readPos;  //смещение первой неотправленной записи
+};
+
+struct MqttSpoolRecord {
+    uint8_t magic;
+    uint8_t retain;
+    uint8_t topicLen;
+    uint8_t reserved;
+    uint16_t payloadLen;
+};
+
+/*
+* Исходящие сообщения, которые не удалось отправить без связи с брокером
+* Сначала копятся в памяти (MQTT_OUTBOX_SIZE), дальше дописываются в MQTT_SPOOL_FILE,
+* после подключения отправляются по порядку, не больше MQTT_OUTBOX_BURST за проход
+* Для статуса в памяти держится только последнее значение по топику и ключу
+* Пока очередь не пуста, новые сообщения тоже идут в нее, чтобы не обгонять старые
+*/
+class MqttOutbox {
+   public:
+    void begin();
+    bool add(const char* topic, const String& payload, bool retain, const char* key);
+    void loop();
+
+    bool empty() const {
+        return !_count && !_spooled;
+    }
+    size_t depth() const {
+        return _count;
+    }
+    size_t spoolSize() const {
+        return _spooled ? _spoolSize - _spoolRead : 0;
+    }
+    void statsToJson(JsonObject& root) const;
+
+    uint32_t _queued = 0;
+    uint32_t _coalesced = 0;  //заменено более новым значением
+    uint32_t _spilled = 0;    //записано в файл
+    uint32_t _dropped = 0;    //файл полон
+    uint32_t _replayed = 0;
+
+   private:
+    struct Entry {
+        String topic;
+        String payload;
+        String key;  //ключ json статуса, пусто - не схлопывать
+        bool retain;
+    };
+
+    bool spill(const char* topic, const String& payload, bool retain);
+    bool replaySpool();
+    void dropSpool();
+
+    Entry _ram[MQTT_OUTBOX_SIZE];
+    size_t _head = 0;
+    size_t _count = 0;
+    bool _spooled = false;
+    uint32_t _spoolRead = 0;
+    uint32_t _spoolSize = 0;
+};
+
+extern MqttOutbox mqttOutbox;
@@ -0,0 +1,57 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+
+#include "Consts.h"
+
+enum MqttSyncStage_t {
+    SYNC_IDLE,
+    SYNC_WIDGETS,
+    SYNC_LIVE,
+    SYNC_STORE,
+    SYNC_TIMES,
+    SYNC_LOGS
+};
+
+/*
+* Полная отправка состояния по HELLO: виджеты, значения, времена узлов, логи
+* Выполняется из loop по частям - не больше MQTT_SYNC_MESSAGES сообщений,
+* MQTT_SYNC_BYTES байт и MQTT_SYNC_BUDGET_MS за проход, и не чаще, чем позволяет mqttLimiter
+* Повторный HELLO начинает заново
+* Куски истории логов не откладываются: если топик занят отложенной точкой,
+* пачка повторяется на следующем проходе, уже отправленные куски пачки пропускаются
+* Лог продолжается с первой точки новее последней отправленной: номера точек
+* сдвигаются, пока кольцо дописывается
+*/
+class MqttSync {
+   public:
+    void start();
+    void loop();
+
+    bool active() const {
+        return _stage != SYNC_IDLE;
+    }
+    uint8_t stage() const {
+        return _stage;
+    }
+    void statsToJson(JsonObject& root) const;
+
+    uint32_t _started = 0;
+    uint32_t _restarted = 0;  //HELLO пришел до окончания предыдущей отправки
+    uint32_t _sent = 0;
+
+   private:
+    bool step(size_t& bytes);  //одно сообщение или переход к следующему этапу, false - повторить позже
+    MqttClass_t stageClass() const;
+    void next(MqttSyncStage_t stage);
+
+    uint8_t _stage = SYNC_IDLE;
+    size_t _index = 0;   //номер значения / узла / лога
+    size_t _cursor = 0;  //позиция в layout / точка в логе, с которой искать продолжение
+    size_t _chunk = 0;   //кусков текущей пачки лога уже отправлено
+    uint32_t _lastTime = 0;  //время последней отправленной точки лога
+    int _grafmax = 0;
+};
+
+extern MqttSync mqttSync;
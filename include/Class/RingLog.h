@@ -0,0 +1,76 @@
+#pragma once
+#include <Arduino.h>
+
+#include <functional>
+
+#include "FileSystem.h"
+
+#define RING_LOG_MAGIC 0x31474C52UL  //"RLG1"
+#define RING_LOG_MAX_RECORD 32
+#define RING_LOG_MAX_CAPACITY 0xFFFF  //capacity в заголовке 16 бит
+#define RING_LOG_TMP_FILE "/ring.tmp"  //короткое имя: в SPIFFS путь не длиннее 31 символа
+
+struct RingLogHeader {
+    uint32_t magic;
+    uint16_t capacity;
+    uint16_t recordSize;
+    uint32_t head;  //номер ячейки для следующей записи
+    uint32_t count;
+};
+
+struct RingLogRecord {
+    uint32_t time;
+    float value;
+};
+
+typedef std::function<void(const RingLogRecord&)> RingLogHandler_t;
+typedef std::function<void(const uint8_t*)> RingLogRawHandler_t;
+
+/*
+* Кольцевой журнал записей фиксированного размера в файле постоянного размера:
+* заголовок и capacity записей, по умолчанию точки графика {время, значение}
+* Добавление записи - запись одной ячейки и заголовка, файл не переписывается
+* Когда кольцо заполнено, перед ячейкой пишется заголовок без самой старой записи:
+* обрыв питания посреди записи теряет одну точку, но не оставляет в журнале испорченную
+* capacity больше RING_LOG_MAX_CAPACITY урезается с сообщением об ошибке
+*/
+class RingLog {
+   public:
+    RingLog(const String& path, size_t capacity, uint16_t recordSize = sizeof(RingLogRecord));
+
+    bool append(uint32_t time, float value) {
+        RingLogRecord rec = {time, value};
+        return appendRaw(&rec);
+    }
+    void forEach(RingLogHandler_t handler, size_t start = 0, size_t limit = SIZE_MAX);  //start - от самой старой записи
+    bool importText(const String& filename);
+
+    bool appendRaw(const void* rec);
+    void forEachRaw(RingLogRawHandler_t handler, size_t start = 0, size_t limit = SIZE_MAX);
+    uint32_t oldestTime();  //время первой записи (любая запись начинается с uint32 времени), 0 - пусто
+
+    size_t count() const {
+        return _hdr.count;
+    }
+    size_t capacity() const {
+        return _hdr.capacity;
+    }
+    const String& path() const {
+        return _path;
+    }
+
+   private:
+    bool open();
+    bool create(uint16_t capacity);
+    bool resize(uint16_t capacity);
+    bool writeRecord(File& file, const void* rec);
+    size_t recordOffset(uint32_t idx) const {
+        return sizeof(RingLogHeader) + idx * _hdr.recordSize;
+    }
+    uint32_t oldestIndex() const {
+        return (_hdr.head + _hdr.capacity - _hdr.count) % _hdr.capacity;
+    }
+
+    String _path;
+    RingLogHeader _hdr;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <Arduino.h>
+
+#include <functional>
+
+#include "Class/RingLog.h"
+
+struct RollupRecord {
+    uint32_t time;  //начало интервала
+    float min;
+    float max;
+    float avg;
+    uint32_t count;
+};
+
+typedef std::function<void(const RollupRecord&)> RollupHandler_t;
+
+/*
+* Уровень прореживания лога: точки собираются в интервалы длиной period секунд,
+* по каждому интервалу в кольцо RingLog пишется min/max/avg/count
+* Текущий интервал держится в памяти и пишется, когда приходит точка из следующего,
+* после перезагрузки его досчитывают из сырых точек начиная с resumeTime()
+*/
+class RollupTier {
+   public:
+    RollupTier(const String& path, size_t capacity, uint32_t period);
+
+    void add(uint32_t time, float value);
+    void forEach(RollupHandler_t handler);  //включая незаконченный интервал
+    uint32_t oldestTime();
+    uint32_t resumeTime();  //начало первого интервала, которого нет в кольце
+
+    size_t count() const {
+        return _ring.count() + (_bucket.count ? 1 : 0);
+    }
+    uint32_t period() const {
+        return _period;
+    }
+
+   private:
+    RingLog _ring;
+    uint32_t _period;
+    RollupRecord _bucket;
+    float _sum;
+};
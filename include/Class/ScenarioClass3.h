@@ -1,85 +1,53 @@
 #pragma once
 #include <Arduino.h>
 
+#include "Class/EventQueue.h"
+#include "Class/KeyTable.h"
 #include "Cmd.h"
 #include "Global.h"
 
-class Scenario {
-   public:
-    void loop() {
-        if (!jsonReadBool(configSetupJson, "scen")) {
-            return;
-        }
-        String allBlocks = scenario;
-        allBlocks.replace("\r\n", "\n");
-        allBlocks.replace("\r", "\n");
-        allBlocks += "\n";
-
-        String incommingEvent = selectToMarker(eventBuf, ",");
-        String incommingEventKey = selectToMarker(incommingEvent, " ");
-        String incommingEventValue = selectToMarkerLast(incommingEvent, " ");
-
-        while (allBlocks.length() > 1) {
-            String oneBlock = selectToMarker(allBlocks, "end\n");
-            String condition = selectToMarker(oneBlock, "\n");
-
-            String setEventKey = selectFromMarkerToMarker(condition, " ", 0);
-
-            if (incommingEventKey == setEventKey) {
-                String setEventSign = selectFromMarkerToMarker(condition, " ", 1);
-                String setEventValue = selectFromMarkerToMarker(condition, " ", 2);
+enum ScenarioSign_t {
+    SS_UNKNOWN,
+    SS_EQUAL,
+    SS_NOT_EQUAL,
+    SS_LESS,
+    SS_MORE,
+    SS_LESS_EQUAL,
+    SS_MORE_EQUAL
+};
 
-                if (!isDigitDotCommaStr(setEventValue)) {
-                    if (setEventValue.indexOf("+-") != -1) {
-                        String setEventValueName = selectToMarker(setEventValue, "+-");
-                        String gisteresisValue = selectToMarkerLast(setEventValue, "+-");
-                        gisteresisValue.replace("+-", "");
-                        String value = getValue(setEventValueName);
-                        String upValue = String(value.toFloat() + gisteresisValue.toFloat());
-                        String lowValue = String(value.toFloat() - gisteresisValue.toFloat());
+//одно правило сценария: условие и команды, разобранные один раз при загрузке
+struct ScenarioRule {
+    ScenarioSign_t sign;
+    bool isRef;          //значение условия - ключ другой переменной
+    bool hasHysteresis;  //условие вида key > ref+-2
+    String value;        //число либо ключ переменной
+    float valueFloat;
+    float hysteresis;
+    String condition;
+    String commands;
+};
 
-                        if (setEventSign == ">") {
-                            setEventValue = upValue;
-                        } else if (setEventSign == "<") {
-                            setEventValue = lowValue;
-                        }
-                    } else {
-                        setEventValue = getValue(setEventValue);
-                    }
-                }
+typedef std::vector<ScenarioRule> ScenarioRules;
 
-                boolean flag = false;
+class Scenario {
+   public:
+    void load(const String& text);
+    void loop();
 
-                if (setEventSign == "=") {
-                    flag = incommingEventValue == setEventValue;
-                } else if (setEventSign == "!=") {
-                    flag = incommingEventValue != setEventValue;
-                } else if (setEventSign == "<") {
-                    flag = incommingEventValue.toFloat() < setEventValue.toFloat();
-                } else if (setEventSign == ">") {
-                    flag = incommingEventValue.toFloat() > setEventValue.toFloat();
-                } else if (setEventSign == ">=") {
-                    flag = incommingEventValue.toFloat() >= setEventValue.toFloat();
-                } else if (setEventSign == "<=") {
-                    flag = incommingEventValue.toFloat() <= setEventValue.toFloat();
-                }
+    size_t rulesCount() const {
+        return _rulesCount;
+    }
 
-                if (flag) {
-                    //SerialPrint("I", "Scenario", "incomming Event Value: " + incommingEventValue);
-                    //SerialPrint("I", "Scenario", "set Event Value: " + setEventValue);
+   private:
+    bool addRule(const String& condition, const String& commands);
+    void processEvent(const QueueRecord& rec);
+    bool isTriggered(const ScenarioRule& rule, const String& incommingEventValue);
 
-                    oneBlock = deleteBeforeDelimiter(oneBlock, "\n");
-                    oneBlock.replace("end", "");
-                    SerialPrint("I", "Scenario", condition + " \n" + oneBlock);
-                    spaceCmdExecute(oneBlock);
-                }
-            }
-            allBlocks = deleteBeforeDelimiter(allBlocks, "end\n");
-        }
-        eventBuf = deleteBeforeDelimiter(eventBuf, ",");
-    }
+    std::vector<ScenarioRules> _rules;  //правила сгруппированные по номеру ключа события в keyTable
+    size_t _rulesCount = 0;
 };
 
 extern Scenario* myScenario;
 
-extern void streamEventUDP(String event);
\ No newline at end of file
+extern void streamEventUDP(String event);
@@ -0,0 +1,54 @@
+#pragma once
+#include <Arduino.h>
+
+#include <functional>
+#include <vector>
+
+#include "Consts.h"
+
+typedef std::function<void(const String&)> SettingsHandler_t;
+
+/*
+* Разобранные один раз настройки из config.json, которые читаются на каждом проходе loop
+* или на каждое событие. Загружаются в loadConfig(), меняются через setBool() из /set
+* configSetupJson остается полной копией для веба и записи в файл
+* setBool() вызывается из асинхронного обработчика веба, поэтому обработчики изменений
+* только отмечаются в нем, а вызываются из loop()
+*/
+class Settings {
+   public:
+    bool scen = false;
+    bool mqttIn = false;
+    bool mqttOut = false;
+    bool snaUdp = false;
+    bool uart = false;
+    bool uartEvents = false;
+    bool telegonof = false;
+    bool teleginput = false;
+    bool autos = false;
+    bool blink = false;
+    bool gateAuto = false;
+    bool evCoalesce = false;                             //новое значение датчика (sensorReport) заменяет еще не разобранное
+    unsigned long loopBudgetMu = LOOP_BUDGET_MU;         //время (мкс) на разбор очередей за один проход loop
+    unsigned long storeQuietMs = STORE_QUIET_MS;         //store.json пишется после паузы в изменениях
+    unsigned long storeMaxDelayMs = STORE_MAX_DELAY_MS;  //но не позже чем через это время после первого
+    unsigned long mqttRate[MC_COUNT] = {MQTT_RATE_STATUS, MQTT_RATE_EVENT, MQTT_RATE_CHART, MQTT_RATE_CONFIG, MQTT_RATE_DEVICE};  //сообщений в минуту
+
+    void load(const String& json);
+    void setBool(const String& name, bool value);
+    void changed(const String& name);  //вызвать обработчики настройки из loop, даже если значение то же
+    void loop();
+
+    //вызывается из loop с именем настройки, если ее значение поменялось
+    void onChange(SettingsHandler_t handler) {
+        _handlers.push_back(handler);
+    }
+
+   private:
+    int flag(const String& name);
+
+    std::vector<SettingsHandler_t> _handlers;
+    uint32_t _changed = 0;  //по биту на флаг из settingsFlags
+};
+
+extern Settings settings;
@@ -0,0 +1,79 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+#define TOPIC_MAX_CAPTURES 4
+
+//часть топика без копирования, указывает в буфер PubSubClient
+struct TopicSegment {
+    const char* ptr;
+    size_t len;
+
+    String toString() const {
+        String str;
+        str.reserve(len);
+        for (size_t i = 0; i < len; i++) {
+            str += ptr[i];
+        }
+        return str;
+    }
+    bool equals(const String& str) const {
+        return str.length() == len && !memcmp(str.c_str(), ptr, len);
+    }
+};
+
+struct TopicMatch {
+    TopicSegment captures[TOPIC_MAX_CAPTURES];  //сегменты на месте '+', '#' - весь остаток
+    uint8_t count;
+};
+
+typedef std::function<void(const char* topic, const TopicMatch& match, const uint8_t* payload, size_t length)> TopicHandler_t;
+
+/*
+* Разбор входящих топиков MQTT: фильтры подписок разложены по сегментам в дерево,
+* топик проходится один раз, обработчик получает сегменты '+' и тело без копирования
+* Счетчики сообщений по маршрутам сохраняются при перестройке дерева (смене префикса)
+*/
+class TopicTrie {
+   public:
+    TopicTrie();
+
+    void add(const String& name, const String& filter, TopicHandler_t handler);
+    bool dispatch(const char* topic, const uint8_t* payload, size_t length);
+    void clear();  //убрать фильтры, счетчики остаются
+
+    size_t routes() const {
+        return _routes.size();
+    }
+    const String& name(size_t i) const {
+        return _routes[i].name;
+    }
+    uint32_t hits(size_t i) const {
+        return _routes[i].hits;
+    }
+    void statsToJson(JsonObject& root) const;
+
+    uint32_t _unmatched = 0;
+
+   private:
+    struct Node {
+        String segment;
+        int16_t route;  //-1 - фильтр здесь не кончается
+        std::vector<uint16_t> children;
+    };
+    struct Route {
+        String name;
+        TopicHandler_t handler;
+        uint32_t hits;
+    };
+
+    int16_t match(uint16_t node, const char* psn, TopicMatch& match) const;
+    uint16_t child(uint16_t node, const char* segment, size_t len);
+
+    std::vector<Node> _nodes;
+    std::vector<Route> _routes;
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "Class/ItemVector.h"
+
+enum ValueType_t {
+    VT_INT,
+    VT_FLOAT,
+    VT_STRING
+};
+
+/*
+* Таблица значений ключ -> значение (целое, дробное или строка)
+* Запись значения не трогает json, он собирается заново только когда его запросили
+* и что то поменялось с прошлого раза
+* _dirty - есть изменения, еще не сохраненные в файл
+*/
+class ValueTable {
+   public:
+    void setStr(const String& key, const String& value);
+    void setInt(const String& key, int value);
+    void setFloat(const String& key, float value);
+
+    bool has(const String& key) const;
+    String getStr(const String& key) const;
+    int getInt(const String& key) const;
+    float getFloat(const String& key) const;
+
+    size_t size() const {
+        return _entries.size();
+    }
+    const String& key(size_t i) const {
+        return _entries.at(i).key;
+    }
+    String getStr(size_t i) const;
+
+    const String& toJson();
+    void fromJson(const String& json);
+    void clear();
+
+    bool isDirty() const {
+        return _dirty;
+    }
+    void clearDirty() {
+        _dirty = false;
+    }
+
+   private:
+    struct Entry {
+        String key;
+        uint8_t type;
+        int intValue;
+        float floatValue;
+        String strValue;
+    };
+
+    Entry& entry(const String& key);
+    const Entry* find(const String& key) const;
+    void changed();
+
+    std::vector<Entry> _entries;
+    std::unordered_map<String, size_t, StringHash> _index;
+    String _json = "{}";
+    bool _jsonValid = true;
+    bool _dirty = false;
+};
+
+extern ValueTable liveValues;   //все данные с датчиков (связан с mqtt)
+extern ValueTable storeValues;  //все данные которые должны сохраняться
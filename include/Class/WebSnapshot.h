@@ -0,0 +1,45 @@
+#pragma once
+#include <Arduino.h>
+
+#include <functional>
+#ifndef ESP8266
+#include <mutex>
+#endif
+
+#include "Consts.h"
+
+typedef std::function<String()> WebSnapshotBuilder_t;
+
+/*
+* Снимок json для асинхронного веб сервера
+* Собирается только в loop (там же, где меняются таблицы значений и счетчики) и только по запросу,
+* обработчик запроса получает копию готовой строки и ничего не собирает сам
+* want() возвращает номер сборки, которую надо отдать: текущую, если она моложе WEB_SNAPSHOT_MIN_MS,
+* иначе следующую - ее loop соберет на ближайшем проходе, пока get() возвращает false
+* На ESP8266 обработчики веба и loop не выполняются одновременно, блокировка нужна только на ESP32
+*/
+class WebSnapshot {
+   public:
+    WebSnapshot(WebSnapshotBuilder_t builder) : _builder(builder) {}
+
+    uint32_t want();                         //любая задача
+    bool get(uint32_t build, String& json);  //любая задача
+    void loop();                             //только loop
+
+   private:
+    WebSnapshotBuilder_t _builder;
+    String _json = "{}";
+    uint32_t _builds = 0;  //только через __atomic
+    bool _wanted = false;  //только через __atomic
+    bool _fresh = false;   //только через __atomic
+    unsigned long _at = 0;
+#ifndef ESP8266
+    std::mutex _mutex;
+#endif
+};
+
+extern WebSnapshot liveSnapshot;   //config.live.json: значения датчиков и счетчики очередей
+extern WebSnapshot storeSnapshot;  //config.store.json
+extern WebSnapshot itemsSnapshot;  //items.stats.json
+
+extern void webSnapshotsLoop();
@@ -3,7 +3,7 @@
 #include "Clock.h"
 #include "Global.h"
 #include "Utils/TimeUtils.h"
-#include "Utils\SerialPrint.h"
+#include "Utils/SerialPrint.h"
 
 extern void clockInit();
 
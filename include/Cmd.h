@@ -61,4 +61,4 @@ extern void loadScenario();
 
 extern void fileCmdExecute(const String& filename);
 extern void csvCmdExecute(String& cmdStr);
-extern void spaceCmdExecute(String& cmdStr);
\ No newline at end of file
+extern void spaceCmdExecute(const String& cmdStr);
\ No newline at end of file
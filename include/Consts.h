@@ -46,6 +46,54 @@
 
 #define NUM_BUTTONS 6
 #define MQTT_RECONNECT_INTERVAL 20000
+#define MQTT_CONNECT_TIMEOUT_MS 2000
+#define MQTT_BACKOFF_MIN_MS 1000
+#define MQTT_BACKOFF_MAX_MS 60000
+#define MQTT_BROKER_SWITCH 5  //неудачных попыток до переключения на другой брокер
+#define MQTT_TOPIC_SIZE 128
+#define MQTT_PAYLOAD_SIZE 128
+#define MQTT_OUTBOX_SIZE 16
+#define MQTT_OUTBOX_BURST 8
+#define MQTT_SPOOL_FILE "/mqtt.spool"
+#ifdef esp8266_1mb
+#define MQTT_SPOOL_MAX 4096
+#else
+#define MQTT_SPOOL_MAX 16384
+#endif
+#define MQTT_SYNC_MESSAGES 8
+#define MQTT_SYNC_BYTES 2048
+#define MQTT_SYNC_BUDGET_MS 20
+#define MQTT_SYNC_LOG_POINTS 16
+#define MQTT_RATE_STATUS 600  //сообщений в минуту
+#define MQTT_RATE_EVENT 300
+#define MQTT_RATE_CHART 120
+#define MQTT_RATE_CONFIG 1200
+#define MQTT_RATE_DEVICE 1200
+#define MQTT_RATE_BURST_S 5  //емкость корзины - трафик за столько секунд
+#define MQTT_RATE_MAX 60000  //больше не бывает: уровень корзины в долях токена должен влезать в uint32_t
+#define MQTT_DEFER_SIZE 16
+#define MQTT_DIAG_INTERVAL 60000
+#define LOOP_BUDGET_MU 3000
+#define STORE_QUIET_MS 2000
+#define STORE_MAX_DELAY_MS 10000
+#define WEB_SNAPSHOT_MIN_MS 500  //снимок для веба собирается не чаще, до тех пор запросы получают готовый
+#define KV_STORE_FILE "/kv.log"
+#define KV_COMPACT_SIZE 4096
+#define LOG_BLOCK_SIZE 256
+#define LOG_CHART_POINTS 500
+#define LOG_QUERY_PENDING 2  //запросов истории из веба в очереди на loop
+#define CHART_CHUNK_SIZE 512
+//записей прореживания на каждый лог по 20 байт, если у элемента не задано r5m[], r1h[]
+#ifdef esp8266_1mb
+#define LOG_ROLLUP_5MIN 144  //12 часов
+#define LOG_ROLLUP_HOUR 168  //неделя
+#else
+#define LOG_ROLLUP_5MIN 288  //сутки
+#define LOG_ROLLUP_HOUR 720  //месяц
+#endif
+#define EVENT_QUEUE_SIZE 16
+#define ORDER_QUEUE_SIZE 32
+#define MYSENSOR_QUEUE_SIZE 64  //презентация шлюзу: по записи на каждый датчик каждой ноды разом
 #define TELEMETRY_UPDATE_INTERVAL_MIN 60
 #define DEVICE_CONFIG_FILE "s.conf.csv"
 #define DEVICE_SCENARIO_FILE "s.scen.txt"
@@ -55,6 +103,7 @@
 //#define LAYOUT_IN_RAM
 //#define UDP_ENABLED
 //#define SSDP_ENABLED
+//#define LOG_COMPRESSED
 
 #ifdef ESP_MODE
 #define EnableButtonIn
@@ -132,6 +181,16 @@ enum ConfigType_t {
     CT_SCENARIO
 };
 
+//классы исходящих mqtt сообщений для ограничения частоты
+enum MqttClass_t {
+    MC_STATUS,
+    MC_EVENT,
+    MC_CHART,
+    MC_CONFIG,
+    MC_DEVICE,  //общий лимит устройства
+    MC_COUNT
+};
+
 //history
 //07.11.2020 (SSDP OFF, UDP OFF)
 //RAM:   [=====     ]  46.8% (used 38376 bytes from 81920 bytes)
@@ -152,7 +211,7 @@ enum ConfigType_t {
 //RAM:   [=====     ]  45.6% (used 37336 bytes from 81920 bytes)
 //Flash: [======    ]  55.3% (used 577396 bytes from 1044464 bytes)
 
-//eventBuf - буфер событий которые проверяются в сценариях,
+//eventQueue - очередь событий которые проверяются в сценариях,
 //и если событие удовлетворяет какому нибудь условию то выполняются указанные команды
 
-//orderBuf - буфер команд которые выполняются сейчас же
+//orderQueue - очередь команд которые выполняются сейчас же
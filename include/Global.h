@@ -17,8 +17,11 @@
 #include "MqttClient.h"
 #include "Upgrade.h"
 
+#include "Class/Settings.h"
+#include "Class/ValueTable.h"
 #include "Utils/FileUtils.h"
 #include "Utils/JsonUtils.h"
+#include "Utils/LoopStats.h"
 #include "Utils/SerialPrint.h"
 #include "Utils/StringUtils.h"
 #include "Utils/SysUtils.h"
@@ -45,8 +48,6 @@ extern boolean savedFromWeb;
 
 // Json
 extern String configSetupJson;   //все настройки
-extern String configLiveJson;    //все данные с датчиков (связан с mqtt)
-extern String configStoreJson;   //все данные которые должны сохраняться
 extern String configOptionJson;  //для трансфера
 extern String telegramMsgJson;
 extern String getValue(String& key);
@@ -55,38 +56,11 @@ extern String getValue(String& key);
 extern String chipId;
 extern String prex;
 extern String all_widgets;
-extern String scenario;
 
 //orders and events
-extern String orderBuf;
-extern String eventBuf;
-extern String mysensorBuf;
 extern String itemsFile;
 extern String itemsLine;
 
-//key lists and numbers
-//=========================================
-extern String impuls_KeyList;
-extern int impuls_EnterCounter;
-//=========================================
-extern String buttonOut_KeyList;
-extern int buttonOut_EnterCounter;
-//=========================================
-extern String input_KeyList;
-extern int input_EnterCounter;
-//=========================================
-extern String output_KeyList;
-extern int output_EnterCounter;
-//=========================================
-extern String pwmOut_KeyList;
-extern int pwmOut_EnterCounter;
-//=========================================
-extern String countDown_KeyList;
-extern int countDown_EnterCounter;
-//=========================================
-extern String logging_KeyList;
-extern int logging_EnterCounter;
-//=========================================
 
 
 
@@ -110,7 +84,7 @@ extern void servo_();
 extern void setLedStatus(LedStatus_t);
 
 //Scenario
-extern void eventGen2(String eventName, String eventValue);
+extern void eventGen2(String eventName, String eventValue, bool coalesce = false);
 extern String add_set(String param_name);
 
 //Timers
@@ -8,4 +8,5 @@ extern void deviceInit();
 extern void prsets_init();
 extern void handle_uptime();
 extern void handle_statistics();
-extern void clearVectors();
\ No newline at end of file
+extern void clearVectors();
+extern void registerItems();
\ No newline at end of file
@@ -2,18 +2,26 @@
 
 #include <Arduino.h>
 
+#include "Class/TopicTrie.h"
+
 extern String mqttPrefix;
 extern String mqttRootDevice;
+extern TopicTrie mqttRoutes;
 
+void mqttConfigInit();
 void mqttInit();
 boolean mqttConnect();
 void mqttReconnect();
 void mqttLoop();
 void mqttSubscribe();
+void mqttRoutesInit();
 
 boolean publish(const String& topic, const String& data);
+boolean publish(const char* topic, const char* data, size_t length, bool retain = false);
 boolean publishData(const String& topic, const String& data);
 boolean publishChart(const String& topic, const String& data);
+boolean publishChart(const String& topic, const char* data, size_t length);
+boolean publishChartChunk(const String& topic, const char* data, size_t length);
 boolean publishControl(String id, String topic, String state);
 boolean publishChart_test(const String& topic, const String& data);
 boolean publishStatus(const String& topic, const String& data);
@@ -21,8 +29,5 @@ boolean publishEvent(const String& topic, const String& data);
 boolean publishInfo(const String& topic, const String& data);
 boolean publishAnyJsonKey(const String& topic, const String& key, const String& data);
 
-void publishWidgets();
-void publishState();
-
 void mqttCallback(char* topic, uint8_t* payload, size_t length);
 const String getStateStr();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 
 String jsonReadStr(String& json, String name);
 
@@ -16,6 +17,50 @@ String jsonWriteFloat(String& json, String name, float value);
 
 String jsonWriteBool(String& json, String name, boolean value);
 
+/*
+* Несколько записей в одну json строку за один разбор и одну сборку
+*   JsonBatch batch(buf);
+*   batch.setStr("page", page).setStr("order", order);
+* строка собирается в commit() или при выходе из области видимости
+*/
+class JsonBatch {
+   public:
+    explicit JsonBatch(String& json);
+    ~JsonBatch();
+
+    JsonBatch& setStr(const String& name, const String& value);
+    JsonBatch& setInt(const String& name, int value);
+    JsonBatch& setFloat(const String& name, float value);
+    void commit();
+
+   private:
+    String& _json;
+    DynamicJsonBuffer _jsonBuffer;
+    JsonObject& _root;
+    bool _changed;
+};
+
 void saveConfig();
 
-void saveStore();
\ No newline at end of file
+/*
+* store.json пишется не сразу: saveStore() только отмечает изменения,
+* storeLoop() пишет файл после паузы storeQuiet или не позже storeMaxDelay,
+* flushStore() - записать немедленно (перед перезагрузкой и обновлением)
+*/
+struct StoreStats {
+    uint32_t saves;   //вызовы saveStore()
+    uint32_t writes;  //реальные записи файла
+
+    void statsToJson(JsonObject& root) const {
+        root["storeSaves"] = saves;
+        root["storeWrites"] = writes;
+    }
+};
+
+extern StoreStats storeStats;
+
+void saveStore();
+
+void storeLoop();
+
+void flushStore();
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+
+#define LOOP_HIST_BUCKETS 12
+
+/*
+* Гистограмма длительности прохода loop: в _hist[i] проходы короче 2^i мс
+* (в _hist[0] - короче 1 мс), в последней ячейке - все остальные
+*/
+struct LoopStats {
+    uint32_t _hist[LOOP_HIST_BUCKETS];
+    uint32_t _max_ms;
+    unsigned long _start_mu;
+
+    LoopStats() : _hist{0}, _max_ms{0}, _start_mu{0} {};
+
+    void begin() {
+        _start_mu = micros();
+    }
+
+    void end() {
+        uint32_t ms = (micros() - _start_mu) / 1000;
+        uint8_t idx = 0;
+        while (idx < LOOP_HIST_BUCKETS - 1 && ms >= (1UL << idx)) {
+            idx++;
+        }
+        _hist[idx]++;
+        if (_max_ms < ms) {
+            _max_ms = ms;
+        }
+    }
+
+    void statsToJson(JsonObject& root) const {
+        JsonArray& hist = root.createNestedArray("loopHist");
+        for (uint8_t i = 0; i < LOOP_HIST_BUCKETS; i++) {
+            hist.add(_hist[i]);
+        }
+        root["loopMax"] = _max_ms;
+    }
+};
+
+extern LoopStats loopStats;
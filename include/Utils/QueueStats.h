@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/*
+* Счетчики очереди событий/команд
+* _pushed, _dropped пишут отправители (атомарно), остальное - только loop
+*/
+struct QueueStats {
+    volatile uint32_t _pushed;
+    volatile uint32_t _dropped;  //не поместилось, не хватило памяти или вытеснено
+    uint32_t _maxDepth;
+    uint32_t _processed;
+    uint32_t _waitMax_ms;
+    uint32_t _waitTotal_ms;
+
+    QueueStats() : _pushed{0}, _dropped{0}, _maxDepth{0}, _processed{0}, _waitMax_ms{0}, _waitTotal_ms{0} {};
+
+    void done(uint32_t wait_ms, uint32_t depth) {
+        _processed++;
+        _waitTotal_ms += wait_ms;
+        if (_waitMax_ms < wait_ms) {
+            _waitMax_ms = wait_ms;
+        }
+        if (_maxDepth < depth) {
+            _maxDepth = depth;
+        }
+    }
+
+    uint32_t waitAvg() const {
+        return _processed ? _waitTotal_ms / _processed : 0;
+    }
+};
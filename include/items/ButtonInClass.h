@@ -56,7 +56,7 @@ class ButtonInClass : public LineParsing {
 
     void switchChangeVirtual(String key, String state) {
         eventGen2(key, state);
-        jsonWriteInt(configLiveJson, key, state.toInt());
+        liveValues.setInt(key, state.toInt());
         publishStatus(key, state);
     }
 };
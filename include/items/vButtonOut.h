@@ -2,11 +2,12 @@
 #pragma once
 #include <Arduino.h>
 
+#include "Class/ItemVector.h"
 #include "Global.h"
 
 class ButtonOut;
 
-typedef std::vector<ButtonOut> MyButtonOutVector;
+typedef ItemVector<ButtonOut> MyButtonOutVector;
 
 class ButtonOut {
    public:
@@ -3,18 +3,25 @@
 
 #include <Arduino.h>
 
+#include "Class/Item.h"
+#include "Class/ItemVector.h"
 #include "Global.h"
 
 class CountDownClass;
 
-typedef std::vector<CountDownClass> MyCountDownVector;
+typedef ItemVector<CountDownClass> MyCountDownVector;
 
-class CountDownClass {
+class CountDownClass : public Item {
    public:
     CountDownClass(String key);
     ~CountDownClass();
 
     void loop();
+
+    const String& itemKey() const {
+        return _key;
+    }
+
     void execute(unsigned int countDownPeriod);
 
    private:
@@ -1,18 +1,25 @@
 #ifdef EnableImpulsOut
 #pragma once
 #include <Arduino.h>
+#include "Class/Item.h"
+#include "Class/ItemVector.h"
 #include "Global.h"
 
 class ImpulsOutClass;
 
-typedef std::vector<ImpulsOutClass> MyImpulsOutVector;
+typedef ItemVector<ImpulsOutClass> MyImpulsOutVector;
 
-class ImpulsOutClass {
+class ImpulsOutClass : public Item {
    public:
-    ImpulsOutClass(unsigned int impulsPin);
+    ImpulsOutClass(unsigned int impulsPin, String key);
     ~ImpulsOutClass();
 
     void loop();
+
+    const String& itemKey() const {
+        return _key;
+    }
+
     void execute(unsigned long impulsPeriod, unsigned int impulsCount);
 
    private:
@@ -23,6 +30,7 @@ class ImpulsOutClass {
     unsigned int _impulsCount = 0;
     unsigned int _impulsCountBuf = 0;
     unsigned int _impulsPin = 0;
+    String _key;
 
 };
 
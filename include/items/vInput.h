@@ -3,11 +3,12 @@
 #include "Consts.h"
 #include <Arduino.h>
 
+#include "Class/ItemVector.h"
 #include "Global.h"
 
 class Input;
 
-typedef std::vector<Input> MyInputVector;
+typedef ItemVector<Input> MyInputVector;
 
 class Input {
    public:
@@ -3,42 +3,61 @@
 #include "Consts.h"
 #include <Arduino.h>
 
+#include "Class/Item.h"
+#include "Class/ItemVector.h"
+#include "Class/RingLog.h"
+#include "Class/Rollup.h"
+#ifdef LOG_COMPRESSED
+#include "Class/BlockLog.h"
+typedef BlockLog LogFile;
+#define LOG_FILE_EXT ".blg"
+#else
+typedef RingLog LogFile;
+#define LOG_FILE_EXT ".bin"
+#endif
 #include "Global.h"
 
 class LoggingClass;
 
-typedef std::vector<LoggingClass> MyLoggingVector;
+typedef ItemVector<LoggingClass> MyLoggingVector;
 
-class LoggingClass {
+class LoggingClass : public Item {
    public:
 
-    LoggingClass(String interval, unsigned int maxPoints, String loggingValueKey, String key, String startState, bool savedFromWeb);
+    LoggingClass(String interval, unsigned int maxPoints, size_t rollup5m, size_t rollup1h, String loggingValueKey, String key, String startState, bool savedFromWeb);
     ~LoggingClass();
 
     void loop();
+    unsigned long interval() const;
+
+    const String& itemKey() const {
+        return _key;
+    }
+
     void execute(String keyOrValue);
 
+    LogFile& logFile() {
+        return _log;
+    }
+
+    void forEachInRange(uint32_t from, uint32_t to, RollupHandler_t handler);
+
    private:
 
-    unsigned long currentMillis;
-    unsigned long prevMillis;
-    unsigned long difference;
     String _interval;
     unsigned int _intervalSec;
     unsigned int _type = 0;
     unsigned int _maxPoints;
     String _loggingValueKey;
     String _key;
-
-    
+    LogFile _log;
+    RollupTier _rollup5m;
+    RollupTier _rollup1h;
 };
 
 extern MyLoggingVector* myLogging;
 
 extern void logging();
 extern void loggingExecute();
-extern void choose_log_date_and_send();
-extern void sendLogData(String file, String topic);
-extern void sendLogData2(String file, String topic);
 extern void cleanLogAndData();
 #endif
@@ -2,11 +2,12 @@
 #pragma once
 #include <Arduino.h>
 
+#include "Class/ItemVector.h"
 #include "Global.h"
 
 class Output;
 
-typedef std::vector<Output> MyOutputVector;
+typedef ItemVector<Output> MyOutputVector;
 
 class Output {
    public:
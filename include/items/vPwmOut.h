@@ -2,11 +2,12 @@
 #pragma once
 #include <Arduino.h>
 #include "Consts.h"
+#include "Class/ItemVector.h"
 #include "Global.h"
 
 class PwmOut;
 
-typedef std::vector<PwmOut> MyPwmOutVector;
+typedef ItemVector<PwmOut> MyPwmOutVector;
 
 class PwmOut {
    public:
@@ -2,6 +2,7 @@
 #pragma once
 #include <Arduino.h>
 
+#include "Class/Item.h"
 #include "Global.h"
 #include "GyverFilters.h"
 
@@ -9,19 +10,24 @@ class SensorAnalog;
 
 typedef std::vector<SensorAnalog> MySensorAnalogVector;
 
-class SensorAnalog {
+class SensorAnalog : public Item {
    public:
     SensorAnalog(String key, unsigned long interval, unsigned int adcPin, int map1, int map2, int map3, int map4, float c);
     ~SensorAnalog();
 
     void loop();
+
+    unsigned long interval() const {
+        return _interval;
+    }
+
+    const String& itemKey() const {
+        return _key;
+    }
+
     void readAnalog();
 
    private:
-    unsigned long currentMillis;
-    unsigned long prevMillis;
-    unsigned long difference;
-
     unsigned long _interval;
 
     String _key;
@@ -3,6 +3,7 @@
 #include <Adafruit_BME280.h>
 #include <Arduino.h>
 
+#include "Class/Item.h"
 #include "Global.h"
 
 extern Adafruit_BME280* bme;
@@ -18,12 +19,21 @@ struct paramsBme {
     float c;
 };
 
-class SensorBme280 {
+class SensorBme280 : public Item {
    public:
     SensorBme280(const paramsBme& paramsTmp, const paramsBme& paramsHum, const paramsBme& paramsPrs);
     ~SensorBme280();
 
     void loop();
+
+    unsigned long interval() const {
+        return _paramsPrs.interval;
+    }
+
+    const String& itemKey() const {
+        return _paramsTmp.key;
+    }
+
     void read();
 
    private:
@@ -31,8 +41,6 @@ class SensorBme280 {
     paramsBme _paramsHum;
     paramsBme _paramsPrs;
 
-    unsigned long prevMillis;
-    unsigned long difference;
 };
 
 extern MySensorBme280Vector* mySensorBme280;
@@ -3,6 +3,7 @@
 #include <Adafruit_BMP280.h>
 #include <Arduino.h>
 
+#include "Class/Item.h"
 #include "Global.h"
 
 extern Adafruit_BMP280* bmp;
@@ -18,20 +19,27 @@ struct paramsBmp {
     float c;
 };
 
-class SensorBmp280 {
+class SensorBmp280 : public Item {
    public:
     SensorBmp280(const paramsBmp& paramsTmp, const paramsBmp& paramsPrs);
     ~SensorBmp280();
 
     void loop();
+
+    unsigned long interval() const {
+        return _paramsPrs.interval;
+    }
+
+    const String& itemKey() const {
+        return _paramsTmp.key;
+    }
+
     void read();
 
    private:
     paramsBmp _paramsTmp;
     paramsBmp _paramsPrs;
 
-    unsigned long prevMillis;
-    unsigned long difference;
 };
 
 extern MySensorBmp280Vector* mySensorBmp280;
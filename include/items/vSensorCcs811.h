@@ -3,6 +3,7 @@
 #include <Arduino.h>
 
 #include "Adafruit_CCS811.h"
+#include "Class/Item.h"
 #include "Global.h"
 #include "GyverFilters.h"
 
@@ -17,7 +18,7 @@ struct paramsCcs811 {
     float c;
 };
 
-class SensorCcs811 {
+class SensorCcs811 : public Item {
    public:
     SensorCcs811(const paramsCcs811& paramsPpm, const paramsCcs811& paramsPpb);
     ~SensorCcs811();
@@ -25,14 +26,21 @@ class SensorCcs811 {
     Adafruit_CCS811* ccs811;
 
     void loop();
+
+    unsigned long interval() const {
+        return _paramsPpb.interval;
+    }
+
+    const String& itemKey() const {
+        return _paramsPpm.key;
+    }
+
     void read();
 
    private:
     paramsCcs811 _paramsPpm;
     paramsCcs811 _paramsPpb;
 
-    unsigned long prevMillis;
-    unsigned long difference;
 };
 
 extern MySensorCcs811Vector* mySensorCcs811;
@@ -3,6 +3,7 @@
 #include <Arduino.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
+#include "Class/Item.h"
 #include "Global.h"
 
 
@@ -13,18 +14,24 @@ class SensorDallas;
 
 typedef std::vector<SensorDallas> MySensorDallasVector;
 
-class SensorDallas {
+class SensorDallas : public Item {
    public:
     SensorDallas(unsigned long interval, unsigned int pin, unsigned int index, String key);
     ~SensorDallas();
 
     void loop();
+
+    unsigned long interval() const {
+        return _interval;
+    }
+
+    const String& itemKey() const {
+        return _key;
+    }
+
     void readDallas();
 
    private:
-    unsigned long currentMillis;
-    unsigned long prevMillis;
-    unsigned long difference;
     unsigned long _interval;
     String _key;
     unsigned int _pin;
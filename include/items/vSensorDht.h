@@ -3,6 +3,7 @@
 #include <Arduino.h>
 #include <DHTesp.h>
 
+#include "Class/Item.h"
 #include "Global.h"
 #include "GyverFilters.h"
 
@@ -18,7 +19,7 @@ struct paramsDht {
     float c;
 };
 
-class SensorDht {
+class SensorDht : public Item {
    public:
     SensorDht(const paramsDht& paramsTmp, const paramsDht& paramsHum);
     ~SensorDht();
@@ -26,14 +27,21 @@ class SensorDht {
     DHTesp* dht;
 
     void loop();
+
+    unsigned long interval() const {
+        return _paramsHum.interval;
+    }
+
+    const String& itemKey() const {
+        return _paramsTmp.key;
+    }
+
     void readTmpHum();
 
    private:
     paramsDht _paramsTmp;
     paramsDht _paramsHum;
 
-    unsigned long prevMillis;
-    unsigned long difference;
 };
 
 extern MySensorDhtVector* mySensorDht;
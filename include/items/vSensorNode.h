@@ -2,6 +2,7 @@
 #pragma once
 #include <Arduino.h>
 
+#include "Class/Item.h"
 #include "Global.h"
 
 class SensorNode;
@@ -16,12 +17,22 @@ struct paramsSensorNode {
     float k;
 };
 
-class SensorNode {
+class SensorNode : public Item {
    public:
     SensorNode(const paramsSensorNode& params);
     ~SensorNode();
 
     void loop();
+
+    //минуты без данных считаются в loop(), секундной точности достаточно
+    unsigned long interval() const {
+        return 1000;
+    }
+
+    const String& itemKey() const {
+        return _params.key;
+    }
+
     void onChange(String newValue, String incommingKey);
     void publish();
 
@@ -37,5 +48,4 @@ class SensorNode {
 extern MySensorNodeVector* mySensorNode;
 
 extern void nodeSensor();
-extern void publishTimes();
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #pragma once
 #include <Arduino.h>
 
+#include "Class/Item.h"
 #include "Global.h"
 #include "PZEMSensor.h"
 #include "SoftUART.h"
@@ -18,13 +19,21 @@ struct paramsPzem {
     float k;
 };
 
-class SensorPzem {
+class SensorPzem : public Item {
    public:
     SensorPzem(const paramsPzem& paramsV, const paramsPzem& paramsA, const paramsPzem& paramsWatt, const paramsPzem& paramsWattHrs, const paramsPzem& paramsHz);
     ~SensorPzem();
 
     void loop();
 
+    unsigned long interval() const {
+        return _paramsHz.interval;
+    }
+
+    const String& itemKey() const {
+        return _paramsV.key;
+    }
+
    private:
     void read();
 
@@ -36,8 +45,6 @@ class SensorPzem {
 
     PZEMSensor* pzem;
 
-    unsigned long prevMillis;
-    unsigned long difference;
 };
 
 extern MySensorPzemVector* mySensorPzem;
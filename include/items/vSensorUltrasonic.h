@@ -2,6 +2,7 @@
 #pragma once
 #include <Arduino.h>
 
+#include "Class/Item.h"
 #include "Global.h"
 #include "GyverFilters.h"
 
@@ -9,19 +10,24 @@ class SensorUltrasonic;
 
 typedef std::vector<SensorUltrasonic> MySensorUltrasonicVector;
 
-class SensorUltrasonic {
+class SensorUltrasonic : public Item {
    public:
     SensorUltrasonic(String key, unsigned long interval, unsigned int trig, unsigned int echo, int map1, int map2, int map3, int map4, float c);
     ~SensorUltrasonic();
 
     void loop();
+
+    unsigned long interval() const {
+        return _interval;
+    }
+
+    const String& itemKey() const {
+        return _key;
+    }
+
     void readUltrasonic();
 
    private:
-    unsigned long currentMillis;
-    unsigned long prevMillis;
-    unsigned long difference;
-
     unsigned long _interval;
 
     String _key;
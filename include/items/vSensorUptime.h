@@ -2,6 +2,7 @@
 #pragma once
 #include <Arduino.h>
 
+#include "Class/Item.h"
 #include "Global.h"
 #include "GyverFilters.h"
 
@@ -14,19 +15,26 @@ struct paramsUptime {
     unsigned long interval;
 };
 
-class SensorUptime {
+class SensorUptime : public Item {
    public:
     SensorUptime(const paramsUptime& paramsUpt);
     ~SensorUptime();
 
     void loop();
+
+    unsigned long interval() const {
+        return _paramsUpt.interval;
+    }
+
+    const String& itemKey() const {
+        return _paramsUpt.key;
+    }
+
     void read();
 
    private:
     paramsUptime _paramsUpt;
 
-    unsigned long prevMillis;
-    unsigned long difference;
 };
 
 extern MySensorUptimeVector* mySensorUptime;
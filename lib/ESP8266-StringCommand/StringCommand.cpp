@@ -29,19 +29,75 @@
 StringCommand::StringCommand()
   : commandList(NULL),
     commandCount(0),
+    commandCapacity(0),
+    commandIndex(NULL),
+    indexSize(0),
     defaultHandler(NULL),
+    delim(' '),
     term('\n'),           // default terminator for commands, newline character
-    last(NULL),
-    main(NULL)
+    bufSize(SERIALCOMMAND_BUFFER + 1),
+    tokenCount(0),
+    tokenCapacity(SERIALCOMMAND_MAXTOKENS),
+    tokenPos(1)
 {
-  strcpy(delim, " "); // strtok_r needs a null-terminated string
+  buffer = (char *) malloc(bufSize);
+  tokens = (char **) malloc(tokenCapacity * sizeof(char *));
   clearBuffer();
 }
 
+/**
+ * FNV-1a hash over the significant part of a command (first SERIALCOMMAND_MAXCOMMANDLENGTH chars).
+ */
+uint32_t StringCommand::hashCommand(const char *command) {
+  uint32_t hash = 2166136261UL;
+  for (byte i = 0; i < SERIALCOMMAND_MAXCOMMANDLENGTH && command[i]; i++) {
+    hash ^= (uint8_t)command[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+/**
+ * Returns position of the command in commandList or -1 if it is not registered.
+ */
+int StringCommand::findCommand(const char *command) {
+  if (!indexSize) {
+    return -1;
+  }
+  uint16_t mask = indexSize - 1;
+  uint16_t slot = hashCommand(command) & mask;
+  while (commandIndex[slot]) {
+    int i = commandIndex[slot] - 1;
+    if (strncmp(command, commandList[i].command, SERIALCOMMAND_MAXCOMMANDLENGTH) == 0) {
+      return i;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return -1;
+}
+
+/**
+ * Reallocates the hash index with the given size and inserts all known commands.
+ */
+void StringCommand::rebuildIndex(uint16_t size) {
+  free(commandIndex);
+  commandIndex = (uint16_t *) calloc(size, sizeof(uint16_t));
+  indexSize = size;
+  uint16_t mask = indexSize - 1;
+  for (uint16_t i = 0; i < commandCount; i++) {
+    uint16_t slot = hashCommand(commandList[i].command) & mask;
+    while (commandIndex[slot]) {
+      slot = (slot + 1) & mask;
+    }
+    commandIndex[slot] = i + 1;
+  }
+}
+
 /**
  * Adds a "command" and a handler function to the list of available commands.
  * This is used for matching a found token in the buffer, and gives the pointer
  * to the handler function to deal with it.
+ * Registering an existing command again (e.g. after deviceInit()) replaces its handler.
  */
 void StringCommand::addCommand(const char *command, void (*function)()) {
   #ifdef SERIALCOMMAND_DEBUG
@@ -51,10 +107,31 @@ void StringCommand::addCommand(const char *command, void (*function)()) {
     Serial.println(command);
   #endif
 
-  commandList = (StringCommandCallback *) realloc(commandList, (commandCount + 1) * sizeof(StringCommandCallback));
+  int i = findCommand(command);
+  if (i != -1) {
+    commandList[i].function = function;
+    return;
+  }
+
+  if (commandCount == commandCapacity) {
+    commandCapacity = commandCapacity ? commandCapacity * 2 : 16;
+    commandList = (StringCommandCallback *) realloc(commandList, commandCapacity * sizeof(StringCommandCallback));
+  }
   strncpy(commandList[commandCount].command, command, SERIALCOMMAND_MAXCOMMANDLENGTH);
+  commandList[commandCount].command[SERIALCOMMAND_MAXCOMMANDLENGTH] = '\0';
   commandList[commandCount].function = function;
   commandCount++;
+
+  if (commandCount * 2 > indexSize) {
+    rebuildIndex(indexSize ? indexSize * 2 : 32);
+  } else {
+    uint16_t mask = indexSize - 1;
+    uint16_t slot = hashCommand(command) & mask;
+    while (commandIndex[slot]) {
+      slot = (slot + 1) & mask;
+    }
+    commandIndex[slot] = commandCount;
+  }
 }
 
 /**
@@ -67,53 +144,77 @@ void StringCommand::setDefaultHandler(void (*function)(const char *)) {
 
 
 /**
- * This checks the Serial stream for characters, and assembles them into a buffer.
- * When the terminator character (default '\n') is seen, it starts parsing the
- * buffer for a prefix command, and calls handlers setup by addCommand() member
+ * Copies the command into the reusable buffer once and splits it in place.
+ * The buffer and the token array grow as needed, so long commands are not truncated.
  */
-void StringCommand::readStr(String sBuffer ) {
-	sBuffer.toCharArray(buffer, SERIALCOMMAND_BUFFER);
-	  #ifdef SERIALCOMMAND_DEBUG
-        Serial.print("Received: ");
-        Serial.println(buffer);
-      #endif
-
-      char *command = strtok_r(buffer, delim, &last);   // Search for command at start of buffer
-      if (command != NULL) {
-        boolean matched = false;
-        for (int i = 0; i < commandCount; i++) {
-          #ifdef SERIALCOMMAND_DEBUG
-            Serial.print("Comparing [");
-            Serial.print(command);
-            Serial.print("] to [");
-            Serial.print(commandList[i].command);
-            Serial.println("]");
-          #endif
-
-
-
-          // Compare the found command against the list of known commands for a match
-          if (strncmp(command, commandList[i].command, SERIALCOMMAND_MAXCOMMANDLENGTH) == 0) {
-            #ifdef SERIALCOMMAND_DEBUG
-              Serial.print("Matched Command: ");
-              Serial.println(command);
-            #endif
-
-            // Execute the stored handler function for the command
-            (*commandList[i].function)();
-            matched = true;
-            break;
-          }
-        }
+void StringCommand::tokenize(const char *str, size_t len) {
+  if (len + 1 > bufSize) {
+    while (bufSize < len + 1) {
+      bufSize *= 2;
+    }
+    buffer = (char *) realloc(buffer, bufSize);
+  }
+  memcpy(buffer, str, len);
+  buffer[len] = '\0';
+
+  tokenCount = 0;
+  tokenPos = 1;
+  char *psn = buffer;
+  char *end = buffer + len;
+  while (psn < end) {
+    while (psn < end && *psn == delim) {
+      *psn++ = '\0';
+    }
+    if (psn == end) {
+      break;
+    }
+    if (tokenCount == tokenCapacity) {
+      tokenCapacity *= 2;
+      tokens = (char **) realloc(tokens, tokenCapacity * sizeof(char *));
+    }
+    tokens[tokenCount++] = psn;
+    while (psn < end && *psn != delim) {
+      psn++;
+    }
+  }
+}
 
+/**
+ * Parses the command, looks up its handler and calls it.
+ * The handler reads its arguments with next() or arg().
+ */
+void StringCommand::readStr(const char *str, size_t len) {
+  tokenize(str, len);
+  #ifdef SERIALCOMMAND_DEBUG
+    Serial.print("Received: ");
+    Serial.write((const uint8_t *)str, len);
+    Serial.println();
+  #endif
 
-        if (!matched && (defaultHandler != NULL)) {
-          (*defaultHandler)(command);
-        }
+  if (tokenCount) {
+    char *command = tokens[0];
+    boolean matched = false;
+    // Look the found command up in the hash index of known commands
+    int i = findCommand(command);
+    if (i != -1) {
+      #ifdef SERIALCOMMAND_DEBUG
+        Serial.print("Matched Command: ");
+        Serial.println(command);
+      #endif
 
+      // Execute the stored handler function for the command
+      (*commandList[i].function)();
+      matched = true;
+    }
 
-      clearBuffer();
+    if (!matched && (defaultHandler != NULL)) {
+      (*defaultHandler)(command);
     }
+  }
+}
+
+void StringCommand::readStr(const String &sBuffer) {
+  readStr(sBuffer.c_str(), sBuffer.length());
 }
 
 /*
@@ -121,7 +222,8 @@ void StringCommand::readStr(String sBuffer ) {
  */
 void StringCommand::clearBuffer() {
   buffer[0] = '\0';
-  bufPos = 0;
+  tokenCount = 0;
+  tokenPos = 1;
 }
 
 /**
@@ -129,9 +231,12 @@ void StringCommand::clearBuffer() {
  * Returns NULL if no more tokens exist.
  */
 char *StringCommand::next() {
-  return strtok_r(NULL, delim, &last);
+  if (tokenPos >= tokenCount) {
+    return NULL;
+  }
+  return tokens[tokenPos++];
 }
 
 char *StringCommand::order() {
-  return strtok_r(buffer, delim, &main);
+  return tokenCount ? tokens[0] : NULL;
 }
@@ -33,8 +33,10 @@
 #endif
 #include <string.h>
 
-// Size of the input buffer in bytes (maximum length of one command plus arguments)
+// Initial size of the input buffer in bytes, it grows to fit longer commands
 #define SERIALCOMMAND_BUFFER 128  //256
+// Initial size of the token array, it grows to fit commands with more arguments
+#define SERIALCOMMAND_MAXTOKENS 16
 // Maximum length of a command excluding the terminating null
 #define SERIALCOMMAND_MAXCOMMANDLENGTH 16
 
@@ -48,10 +50,16 @@ class StringCommand {
     void addCommand(const char *command, void(*function)());  // Add a command to the processing dictionary.
     void setDefaultHandler(void (*function)(const char *));   // A handler to call when no valid command received.
 
-    void readStr(String sBuffer );    // Main entry point.
+    void readStr(const char *str, size_t len);  // Main entry point.
+    void readStr(const String &sBuffer);
     void clearBuffer();   // Clears the input buffer.
     char *next();         // Returns pointer to next token found in command buffer (for getting arguments to commands).
-    char *order();
+    char *order();        // Returns the command token itself.
+
+    // Pre-split tokens of the command being handled: arg(0) is the command, arguments start at 1.
+    // Pointers are valid until the next readStr() call.
+    uint16_t argCount() const { return tokenCount; }
+    const char *arg(uint16_t i) const { return i < tokenCount ? tokens[i] : ""; }
 
   private:
     // Command/handler dictionary
@@ -60,18 +68,31 @@ class StringCommand {
       void (*function)();
     };                                    // Data structure to hold Command/Handler function key-value pairs
     StringCommandCallback *commandList;   // Actual definition for command/handler array
-    byte commandCount;
+    uint16_t commandCount;
+    uint16_t commandCapacity;             // Allocated entries in commandList, grows by doubling
+
+    // Open addressing hash index: slot holds commandList position + 1, 0 marks an empty slot
+    uint16_t *commandIndex;
+    uint16_t indexSize;                   // Power of two, kept at least twice commandCount
+
+    static uint32_t hashCommand(const char *command);
+    int findCommand(const char *command);
+    void rebuildIndex(uint16_t size);
 
     // Pointer to the default handler function
     void (*defaultHandler)(const char *);
 
-    char delim[2]; // null-terminated list of character to be used as delimeters for tokenizing (default " ")
+    char delim;    // Character used as delimeter for tokenizing (default ' ')
     char term;     // Character that signals end of command (default '\n')
 
-    char buffer[SERIALCOMMAND_BUFFER + 1]; // Buffer of stored characters while waiting for terminator character
-    byte bufPos;                        // Current position in the buffer
-    char *last;                         // State variable used by strtok_r during processing
-    char *main;
+    char *buffer;        // Copy of the command split in place into tokens, reused between calls
+    size_t bufSize;
+    char **tokens;       // Pointers into buffer, one per token
+    uint16_t tokenCount;
+    uint16_t tokenCapacity;
+    uint16_t tokenPos;   // Next token returned by next()
+
+    void tokenize(const char *str, size_t len);
 };
 
 #endif //StringCommand_h
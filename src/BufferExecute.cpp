@@ -1,6 +1,12 @@
 #include "BufferExecute.h"
 
+#include "Class/Deadband.h"
+#include "Class/EventCoalescer.h"
+#include "Class/MqttLimiter.h"
+#include "Class/MqttOutbox.h"
+#include "Class/MqttSync.h"
 #include "Global.h"
+#include "Init.h"
 #include "SoftUART.h"
 #include "items/test.h"
 #include "items/vButtonOut.h"
@@ -21,12 +27,24 @@
 #include "items/vSensorUptime.h"
 #include "items/vSensorNode.h"
 
-void loopCmdAdd(const String& cmdStr) {
+//команды не теряются молча: что не поместилось в очередь - в лог и false отправителю
+bool orderAdd(const String& list, uint8_t source) {
+    size_t lost = 0;
+    orderQueue.pushList(list, source, &lost);
+    if (lost) {
+        SerialPrint("E", "CMD", "order queue full, lost " + String((int)lost) + " of: " + list);
+        return false;
+    }
+    return true;
+}
+
+bool loopCmdAdd(const String& cmdStr, uint8_t source) {
+    bool ok = true;
     if (cmdStr.endsWith(",")) {
-        orderBuf += cmdStr;
+        ok = orderAdd(cmdStr, source);
 #ifdef EnableUart
-        if (jsonReadBool(configSetupJson, "uart")) {
-            if (jsonReadBool(configSetupJson, "uartEvents")) {
+        if (settings.uart) {
+            if (settings.uartEvents) {
                 if (myUART) {
                     myUART->print(cmdStr);
                     SerialPrint("I", "<=UART", cmdStr);
@@ -35,6 +53,7 @@ void loopCmdAdd(const String& cmdStr) {
         }
 #endif
     }
+    return ok;
 }
 
 void fileCmdExecute(const String& filename) {
@@ -142,55 +161,70 @@ void csvCmdExecute(String& cmdStr) {
     }
 }
 
-void spaceCmdExecute(String& cmdStr) {
-    cmdStr += "\r\n";
-    cmdStr.replace("\r\n", "\n");
-    cmdStr.replace("\r", "\n");
-    while (cmdStr.length()) {
-        String buf = selectToMarker(cmdStr, "\n");
-        sCmd.readStr(buf);
-        cmdStr = deleteBeforeDelimiter(cmdStr, "\n");
+void spaceCmdExecute(const String& cmdStr) {
+    //каждая строка разбирается прямо из cmdStr, без промежуточных копий
+    const char* psn = cmdStr.c_str();
+    const char* end = psn + cmdStr.length();
+    while (psn < end) {
+        const char* eol = psn;
+        while (eol < end && *eol != '\n' && *eol != '\r') {
+            eol++;
+        }
+        if (eol > psn) {
+            sCmd.readStr(psn, eol - psn);
+        }
+        psn = eol + 1;
     }
 }
 
 void loopCmdExecute() {
-    if (orderBuf.length()) {
-        String tmp = selectToMarker(orderBuf, ",");  //выделяем первую команду rel 5 1,
+    unsigned long start = micros();
+    //выполняем команды пока не выйдет время отведенное на проход, но минимум одну
+    QueueRecord rec;
+    bool done = false;
+    while (orderQueue.pop(rec)) {
+        done = true;
+        String tmp = rec.key;  //собираем команду rel 5 1
+        if (rec.value.length()) {
+            tmp += " ";
+            tmp += rec.value;
+        }
         SerialPrint("I", "CMD", "do: " + tmp);
-        sCmd.readStr(tmp);                                //выполняем
-        orderBuf = deleteBeforeDelimiter(orderBuf, ",");  //осекаем
+        sCmd.readStr(tmp);  //выполняем
+        if (micros() - start >= settings.loopBudgetMu) {
+            break;
+        }
+    }
+    if (done) {
+        registerItems();  //команда могла создать первый элемент своего типа
     }
 }
 
-void addKey(String& key, String& keyNumberTable, int number) {
-    keyNumberTable += key + " " + String(number) + ",";
-}
-
-int getKeyNum(String& key, String& keyNumberTable) {
-    String keyNumberTableBuf = keyNumberTable;
-
-    int number = -1;
-    while (keyNumberTableBuf.length()) {
-        String tmp = selectToMarker(keyNumberTableBuf, ",");
-        String keyIncomming = selectToMarker(tmp, " ");
-        if (keyIncomming == key) {
-            number = selectToMarkerLast(tmp, " ").toInt();
-        }
-        keyNumberTableBuf = deleteBeforeDelimiter(keyNumberTableBuf, ",");
-    }
-    return number;
+//каждый модуль сам выкладывает свои счетчики
+String getQueueStatsJson(const String& json) {
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.parseObject(json);
+    eventQueue.statsToJson(root, "evQueue");
+    orderQueue.statsToJson(root, "cmdQueue");
+    eventCoalescer.statsToJson(root);
+    storeStats.statsToJson(root);
+    mqttSync.statsToJson(root);
+    mqttRoutes.statsToJson(root);
+    mqttOutbox.statsToJson(root);
+    mqttLimiter.statsToJson(root);
+    deadband.statsToJson(root);
+    loopStats.statsToJson(root);
+    String ret;
+    root.printTo(ret);
+    return ret;
 }
 
 String getValue(String& key) {
-    String live = jsonReadStr(configLiveJson, key);
-    String store = jsonReadStr(configStoreJson, key);
-    if (live != nullptr) {
-        return live;
-    } else if (store != nullptr) {
-        return store;
-    } else if (store == nullptr && live == nullptr) {
-        return "no value";
+    if (liveValues.has(key)) {
+        return liveValues.getStr(key);
+    } else if (storeValues.has(key)) {
+        return storeValues.getStr(key);
     } else {
-        return "data error";
+        return "no value";
     }
 }
\ No newline at end of file
@@ -9,11 +9,11 @@ void busInit() {
             if (tmp == "error") {
                 tmp = i2c_scan();
                 Serial.println(tmp);
-                jsonWriteStr(configLiveJson, "i2c", tmp);
+                liveValues.setStr("i2c", tmp);
             }
             else {
                 Serial.println(tmp);
-                jsonWriteStr(configLiveJson, "i2c", tmp);
+                liveValues.setStr("i2c", tmp);
             }
         },
         nullptr);
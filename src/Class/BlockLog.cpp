@@ -0,0 +1,279 @@
+#include "Class/BlockLog.h"
+
+#include "Utils/FileUtils.h"
+#include "Utils/SerialPrint.h"
+
+//столько же места, сколько заняли бы maxPoints несжатых точек, но не меньше двух блоков
+static uint16_t blocksFor(size_t maxPoints) {
+    if (maxPoints > RING_LOG_MAX_CAPACITY) {
+        maxPoints = RING_LOG_MAX_CAPACITY;
+    }
+    size_t blocks = (maxPoints * sizeof(RingLogRecord) + LOG_BLOCK_SIZE - 1) / LOG_BLOCK_SIZE;
+    return blocks < 2 ? 2 : blocks;
+}
+
+BlockLog::BlockLog(const String& path, size_t maxPoints) {
+    _path = path;
+    _points = 0;
+    _written = 0;
+    if (maxPoints > RING_LOG_MAX_CAPACITY) {
+        SerialPrint("E", "BlockLog", _path + " points " + String((unsigned long)maxPoints) + " > " + String(RING_LOG_MAX_CAPACITY));
+    }
+    uint16_t wanted = blocksFor(maxPoints);
+    if (!open()) {
+        create(wanted);
+    } else if (_hdr.blocks != wanted) {
+        resize(wanted);
+    }
+}
+
+bool BlockLog::open() {
+    File file = FileFS.open(_path, FILE_READ);
+    if (!file) {
+        return false;
+    }
+    BlockLogHeader hdr;
+    bool ok = file.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              hdr.magic == BLOCK_LOG_MAGIC &&
+              hdr.blockSize == LOG_BLOCK_SIZE &&
+              hdr.blocks >= 2 && hdr.head < hdr.blocks && hdr.used <= hdr.blocks;
+    if (ok) {
+        _hdr = hdr;
+        //недописанный текущий блок отбрасывается, заполненные блоки до него остаются
+        while (_hdr.used) {
+            file.seek(blockOffset(_hdr.head), SeekSet);
+            if (file.read(_current.data(), LOG_BLOCK_SIZE) == LOG_BLOCK_SIZE && _current.resume()) {
+                break;
+            }
+            SerialPrint("E", "BlockLog", "block " + String(_hdr.head) + " dropped in " + _path);
+            _hdr.head = (_hdr.head + _hdr.blocks - 1) % _hdr.blocks;
+            _hdr.used--;
+        }
+        _points = 0;
+        _written = 0;
+        for (uint16_t i = 1; i < _hdr.used; i++) {
+            _points += blockCount(file, (_hdr.head + _hdr.blocks - i) % _hdr.blocks);
+        }
+        if (_hdr.used) {
+            _points += _current.count();
+            _written = _current.used();
+        } else {
+            _current = GorillaBlock();
+        }
+    }
+    file.close();
+    if (!ok) {
+        SerialPrint("E", "BlockLog", "broken " + _path);
+    }
+    return ok;
+}
+
+bool BlockLog::create(uint16_t blocks) {
+    _hdr.magic = BLOCK_LOG_MAGIC;
+    _hdr.blockSize = LOG_BLOCK_SIZE;
+    _hdr.blocks = blocks;
+    _hdr.head = 0;
+    _hdr.used = 0;
+    _points = 0;
+    _written = 0;
+    File file = FileFS.open(_path, FILE_WRITE);
+    if (!file) {
+        SerialPrint("E", "BlockLog", "create " + _path);
+        return false;
+    }
+    file.write((const uint8_t*)&_hdr, sizeof(_hdr));
+    file.close();
+    return true;
+}
+
+bool BlockLog::resize(uint16_t blocks) {
+    String tmpPath = BLOCK_LOG_TMP_FILE;
+    FileFS.remove(tmpPath);
+    BlockLog tmp(tmpPath, 0);
+    tmp.create(blocks);
+    File file = FileFS.open(tmpPath, "r+");
+    if (!file) {
+        return false;
+    }
+    forEach([&tmp, &file](const RingLogRecord& rec) {
+        tmp.appendTo(file, rec.time, rec.value);
+    });
+    file.close();
+    FileFS.remove(_path);
+    if (!FileFS.rename(tmpPath, _path)) {
+        SerialPrint("E", "BlockLog", "rename " + tmpPath);
+        return false;
+    }
+    _hdr = tmp._hdr;
+    _current = tmp._current;
+    _points = tmp._points;
+    _written = tmp._written;
+    return true;
+}
+
+uint16_t BlockLog::blockCount(File& file, uint16_t block) {
+    uint8_t hdr[GORILLA_HEADER_SIZE];
+    file.seek(blockOffset(block), SeekSet);
+    if (file.read(hdr, sizeof(hdr)) != sizeof(hdr)) {
+        return 0;
+    }
+    return hdr[8] | (hdr[9] << 8);
+}
+
+bool BlockLog::appendTo(File& file, uint32_t time, float value) {
+    size_t from = 0;  //новый блок пишется целиком, чтобы в файле не было дыр
+    size_t to = LOG_BLOCK_SIZE;
+    if (!_hdr.used) {
+        _hdr.used = 1;
+        _current.begin(time, value);
+    } else {
+        size_t used = _current.used();
+        if (_current.append(time, value)) {
+            from = used - 1;  //последний байт мог быть заполнен частично
+            if (from > _written) {
+                from = _written;  //прошлая запись не прошла - дописываем и ее
+            }
+            to = _current.used();
+        } else {
+            //блок полон - переходим к следующему, самый старый перезаписывается
+            _hdr.head = (_hdr.head + 1) % _hdr.blocks;
+            if (_hdr.used < _hdr.blocks) {
+                _hdr.used++;
+            } else {
+                _points -= blockCount(file, _hdr.head);
+            }
+            _current.begin(time, value);
+        }
+    }
+    _points++;
+
+    //сначала новые биты, потом счетчик блока, последним заголовок файла:
+    //при обрыве питания посередине счетчики указывают только на уже записанные данные.
+    //Новый блок пишется одним куском - на него еще не ссылается заголовок файла
+    size_t base = blockOffset(_hdr.head);
+    bool ok;
+    if (from == 0) {
+        file.seek(base, SeekSet);
+        ok = file.write(_current.data(), to) == to;
+    } else {
+        if (from < GORILLA_HEADER_SIZE) {
+            from = GORILLA_HEADER_SIZE;
+        }
+        file.seek(base + from, SeekSet);
+        ok = file.write(_current.data() + from, to - from) == to - from;
+        file.seek(base, SeekSet);
+        ok = ok && file.write(_current.data(), GORILLA_HEADER_SIZE) == GORILLA_HEADER_SIZE;
+    }
+    file.seek(0, SeekSet);
+    ok = ok && file.write((const uint8_t*)&_hdr, sizeof(_hdr)) == sizeof(_hdr);
+    _written = ok ? to : 0;
+    return ok;
+}
+
+bool BlockLog::append(uint32_t time, float value) {
+    File file = FileFS.open(_path, "r+");
+    if (!file) {
+        //файл удалили (очистка логов) - начинаем заново
+        if (!create(_hdr.blocks)) {
+            return false;
+        }
+        file = FileFS.open(_path, "r+");
+        if (!file) {
+            return false;
+        }
+    }
+    bool ok = appendTo(file, time, value);
+    file.close();
+    return ok;
+}
+
+//блоки до start пропускаются по счетчику в заголовке, без распаковки
+void BlockLog::forEach(RingLogHandler_t handler, size_t start, size_t limit) {
+    if (!_hdr.used || !limit) {
+        return;
+    }
+    File file = FileFS.open(_path, FILE_READ);
+    if (!file) {
+        return;
+    }
+    GorillaBlock block;
+    for (uint16_t i = _hdr.used; i > 0 && limit; i--) {
+        uint16_t idx = (_hdr.head + _hdr.blocks - (i - 1)) % _hdr.blocks;
+        const uint8_t* data = _current.data();
+        if (idx != _hdr.head) {
+            uint16_t count = blockCount(file, idx);
+            if (start >= count) {
+                start -= count;
+                continue;
+            }
+            file.seek(blockOffset(idx), SeekSet);
+            if (file.read(block.data(), LOG_BLOCK_SIZE) != LOG_BLOCK_SIZE) {
+                continue;
+            }
+            data = block.data();
+        }
+        GorillaDecoder decoder(data, LOG_BLOCK_SIZE);
+        RingLogRecord rec;
+        while (limit && decoder.next(rec.time, rec.value)) {
+            if (start) {
+                start--;
+                continue;
+            }
+            handler(rec);
+            limit--;
+        }
+    }
+    file.close();
+}
+
+//время первой точки - в заголовке самого старого блока
+uint32_t BlockLog::oldestTime() {
+    if (!_points) {
+        return 0;
+    }
+    uint16_t idx = (_hdr.head + _hdr.blocks - (_hdr.used - 1)) % _hdr.blocks;
+    uint8_t buf[4];
+    if (idx == _hdr.head) {
+        memcpy(buf, _current.data(), sizeof(buf));
+    } else {
+        File file = FileFS.open(_path, FILE_READ);
+        if (!file) {
+            return 0;
+        }
+        file.seek(blockOffset(idx), SeekSet);
+        bool ok = file.read(buf, sizeof(buf)) == sizeof(buf);
+        file.close();
+        if (!ok) {
+            return 0;
+        }
+    }
+    return buf[0] | (buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+//перенос старого текстового лога "время значение" построчно
+bool BlockLog::importText(const String& filename) {
+    File src = FileFS.open(filename, FILE_READ);
+    if (!src) {
+        return false;
+    }
+    File file = FileFS.open(_path, "r+");
+    if (!file) {
+        src.close();
+        return false;
+    }
+    size_t lines = 0;
+    while (src.available()) {
+        String line = src.readStringUntil('\n');
+        int space = line.indexOf(' ');
+        if (space <= 0) {
+            continue;
+        }
+        appendTo(file, line.substring(0, space).toInt(), line.substring(space + 1).toFloat());
+        lines++;
+    }
+    file.close();
+    src.close();
+    removeFile(filename);
+    SerialPrint("I", "BlockLog", filename + " -> " + _path + ", points: " + String(lines));
+    return true;
+}
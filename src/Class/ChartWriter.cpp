@@ -0,0 +1,92 @@
+#include "Class/ChartWriter.h"
+
+#define CHART_HEAD "{\"status\":["
+#define CHART_TAIL "]}"
+
+ChartWriter::ChartWriter(size_t maxPoints, ChartFlush_t flush) {
+    _maxPoints = maxPoints;
+    _flush = flush;
+    open();
+}
+
+void ChartWriter::open() {
+    _len = sizeof(CHART_HEAD) - 1;
+    memcpy(_buf, CHART_HEAD, _len);
+    _points = 0;
+}
+
+void ChartWriter::send() {
+    memcpy(_buf + _len, CHART_TAIL, sizeof(CHART_TAIL) - 1);
+    _flush(_buf, _len + sizeof(CHART_TAIL) - 1);
+    open();
+}
+
+void ChartWriter::add(uint32_t time, float value) {
+    if (_len + CHART_POINT_MAX + sizeof(CHART_TAIL) > CHART_CHUNK_SIZE) {
+        send();
+    }
+    _len += formatPoint(_buf + _len, CHART_CHUNK_SIZE - _len, time, value, !_points);
+    _points++;
+    if (_maxPoints && _points >= _maxPoints) {
+        send();
+    }
+}
+
+void ChartWriter::finish() {
+    send();
+}
+
+size_t ChartWriter::formatPoint(char* buf, size_t size, uint32_t time, float value, bool first) {
+    char num[48];
+    dtostrf(value, 1, 2, num);  //как String(float)
+    int len = snprintf(buf, size, "%s{\"x\":%u,\"y1\":%s}", first ? "" : ",", (unsigned)time, num);
+    return len < (int)size ? len : size - 1;
+}
+
+//вектор забирается целиком, чтобы не копировать точки
+ChartFiller::ChartFiller(std::vector<RingLogRecord>& points) {
+    _points.swap(points);
+    _next = 0;
+    _stage = 0;
+    _pieceLen = 0;
+    _piecePos = 0;
+}
+
+bool ChartFiller::nextPiece() {
+    if (_stage == 0) {
+        _pieceLen = sizeof(CHART_HEAD) - 1;
+        memcpy(_piece, CHART_HEAD, _pieceLen);
+        _stage = _points.empty() ? 2 : 1;
+    } else if (_stage == 1) {
+        const RingLogRecord& rec = _points[_next];
+        _pieceLen = ChartWriter::formatPoint(_piece, sizeof(_piece), rec.time, rec.value, !_next);
+        if (++_next == _points.size()) {
+            _stage = 2;
+        }
+    } else if (_stage == 2) {
+        _pieceLen = sizeof(CHART_TAIL) - 1;
+        memcpy(_piece, CHART_TAIL, _pieceLen);
+        _stage = 3;
+    } else {
+        return false;
+    }
+    _piecePos = 0;
+    return true;
+}
+
+size_t ChartFiller::fill(uint8_t* buf, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen) {
+        if (_piecePos == _pieceLen && !nextPiece()) {
+            break;
+        }
+        size_t part = _pieceLen - _piecePos;
+        if (part > maxLen - len) {
+            part = maxLen - len;
+        }
+        memcpy(buf + len, _piece + _piecePos, part);
+        _piecePos += part;
+        len += part;
+    }
+    return len;
+}
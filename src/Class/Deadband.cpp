@@ -0,0 +1,82 @@
+#include "Class/Deadband.h"
+
+#include "Global.h"
+
+Deadband deadband;
+
+void Deadband::add(const String& key, const String& db, const String& minint, const String& maxint) {
+    if (db == "" && minint == "" && maxint == "") {
+        return;
+    }
+    Filter filter;
+    filter.key = key;
+    filter.db = db.toFloat();
+    filter.minInt_ms = minint.toInt() * 1000;
+    filter.maxInt_ms = maxint.toInt() * 1000;
+    filter.reported = false;
+    filter.last = 0;
+    filter.lastReport = 0;
+    filter.suppressed = 0;
+    for (auto& item : _filters) {
+        if (item.key == key) {
+            item = filter;
+            return;
+        }
+    }
+    _filters.push_back(filter);
+}
+
+bool Deadband::pass(const String& key, float value) {
+    for (auto& filter : _filters) {
+        if (filter.key != key) {
+            continue;
+        }
+        unsigned long now = millis();
+        unsigned long elapsed = now - filter.lastReport;
+        bool send;
+        if (!filter.reported) {
+            send = true;
+        } else if (filter.minInt_ms && elapsed < filter.minInt_ms) {
+            send = false;
+        } else if (filter.maxInt_ms && elapsed >= filter.maxInt_ms) {
+            send = true;  //контрольная отправка
+        } else {
+            //сравнение с последним отправленным, а не прочитанным, чтобы медленный дрейф тоже дошел
+            send = fabs(value - filter.last) > filter.db;
+        }
+        if (!send) {
+            filter.suppressed++;
+            _suppressed++;
+            return false;
+        }
+        filter.reported = true;
+        filter.last = value;
+        filter.lastReport = now;
+        _passed++;
+        return true;
+    }
+    return true;
+}
+
+void Deadband::clear() {
+    _filters.clear();
+}
+
+void Deadband::statsToJson(JsonObject& root) const {
+    root["dbPassed"] = _passed;
+    root["dbSuppressed"] = _suppressed;
+    JsonObject& keys = root.createNestedObject("dbKeys");
+    for (size_t i = 0; i < _filters.size(); i++) {
+        keys[_filters[i].key] = _filters[i].suppressed;
+    }
+}
+
+void sensorReport(const String& key, float value) {
+    liveValues.setFloat(key, value);
+    if (!deadband.pass(key, value)) {
+        return;
+    }
+    String str(value);
+    eventGen2(key, str, true);
+    publishStatus(key, str);
+}
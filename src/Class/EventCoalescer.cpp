@@ -0,0 +1,69 @@
+#include "Class/EventCoalescer.h"
+
+#include "Class/KeyTable.h"
+
+EventCoalescer eventCoalescer;
+
+//кольцо разворачивается с начала, чтобы порядок ожидающих ключей сохранился
+void EventCoalescer::grow(size_t size) {
+    std::vector<uint16_t> order(size);
+    for (size_t i = 0; i < _count; i++) {
+        order[i] = _order[(_head + i) % _order.size()];
+    }
+    _order.swap(order);
+    _slots.resize(size);
+    _head = 0;
+}
+
+void EventCoalescer::add(uint16_t keyId, const String& value) {
+    if (keyId >= _slots.size()) {
+        grow(keyTable.size() > keyId ? keyTable.size() : keyId + 1);
+    }
+    Slot& slot = _slots[keyId];
+    slot.value = value;
+    if (slot.pending) {
+        _coalesced++;
+        return;
+    }
+    slot.pending = true;
+    slot.stamp = millis();
+    _order[(_head + _count) % _order.size()] = keyId;
+    _count++;
+}
+
+bool EventCoalescer::pop(QueueRecord& rec) {
+    if (!_count) {
+        return false;
+    }
+    uint16_t keyId = _order[_head];
+    _head = (_head + 1) % _order.size();
+    _count--;
+
+    Slot& slot = _slots[keyId];
+    slot.pending = false;
+
+    const String& key = keyTable.name(keyId);
+    rec.keyId = keyId;
+    rec.source = ES_LOCAL;
+    rec.stamp = slot.stamp;
+    rec.key = key;
+    rec.value = slot.value;
+    _processed++;
+    return true;
+}
+
+void EventCoalescer::clear() {
+    QueueRecord rec;
+    while (pop(rec)) {
+        eventQueue.push(rec.key, rec.value, rec.source);
+    }
+    _slots.clear();
+    _order.clear();
+    _head = 0;
+}
+
+void EventCoalescer::statsToJson(JsonObject& root) const {
+    root["evLastDepth"] = depth();
+    root["evLastDone"] = _processed;
+    root["evCoalesced"] = _coalesced;
+}
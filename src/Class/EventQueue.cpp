@@ -0,0 +1,197 @@
+#include "Class/EventQueue.h"
+
+#include "Class/KeyTable.h"
+
+EventQueue eventQueue(EVENT_QUEUE_SIZE, QD_OLDEST);
+EventQueue orderQueue(ORDER_QUEUE_SIZE, QD_NEWEST);
+#ifdef MYSENSORS
+EventQueue mysensorQueue(MYSENSOR_QUEUE_SIZE, QD_NEWEST);
+#endif
+
+#ifdef ESP8266
+//на ESP8266 одно ядро и нет инструкции сравнения с обменом, атомарность через запрет прерываний
+static inline bool casU32(volatile uint32_t* ptr, uint32_t expected, uint32_t desired) {
+    uint32_t savedPS = xt_rsil(15);
+    bool ok = *ptr == expected;
+    if (ok) {
+        *ptr = desired;
+    }
+    xt_wsr_ps(savedPS);
+    return ok;
+}
+
+static inline void addU32(volatile uint32_t* ptr, uint32_t value) {
+    uint32_t savedPS = xt_rsil(15);
+    *ptr += value;
+    xt_wsr_ps(savedPS);
+}
+#else
+static inline bool casU32(volatile uint32_t* ptr, uint32_t expected, uint32_t desired) {
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static inline void addU32(volatile uint32_t* ptr, uint32_t value) {
+    __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED);
+}
+#endif
+
+static inline uint32_t loadU32(const volatile uint32_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeU32(volatile uint32_t* ptr, uint32_t value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+EventQueue::EventQueue(size_t capacity, QueueDrop_t policy) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    _cells = new Cell[size];
+    for (size_t i = 0; i < size; i++) {
+        _cells[i].seq = i;
+    }
+    _mask = size - 1;
+    _policy = policy;
+    _enqueuePos = 0;
+    _dequeuePos = 0;
+}
+
+EventQueue::~EventQueue() {
+    while (take(nullptr)) {
+    }
+    delete[] _cells;
+}
+
+bool EventQueue::push(const char* key, size_t keyLen, const char* value, size_t valueLen, uint8_t source) {
+    //память под запись берется до захвата ячейки, чтобы ячейка не ждала malloc
+    char* data = (char*)malloc(keyLen + valueLen + 2);
+    if (!data) {
+        addU32(&stats._dropped, 1);
+        return false;
+    }
+    memcpy(data, key, keyLen);
+    data[keyLen] = '\0';
+    memcpy(data + keyLen + 1, value, valueLen);
+    data[keyLen + valueLen + 1] = '\0';
+
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        uint32_t pos = loadU32(&_enqueuePos);
+        while (true) {
+            Cell* cell = &_cells[pos & _mask];
+            int32_t dif = (int32_t)loadU32(&cell->seq) - (int32_t)pos;
+            if (dif == 0) {
+                if (casU32(&_enqueuePos, pos, pos + 1)) {
+                    //ячейка наша, пока не опубликуем seq
+                    cell->source = source;
+                    cell->stamp = millis();
+                    cell->data = data;
+                    cell->keyLen = keyLen;
+                    storeU32(&cell->seq, pos + 1);
+                    addU32(&stats._pushed, 1);
+                    return true;
+                }
+                pos = loadU32(&_enqueuePos);
+            } else if (dif < 0) {
+                break;  //очередь полна
+            } else {
+                pos = loadU32(&_enqueuePos);
+            }
+        }
+        if (_policy != QD_OLDEST || attempt) {
+            break;
+        }
+        if (take(nullptr)) {
+            addU32(&stats._dropped, 1);
+        }
+    }
+    free(data);
+    addU32(&stats._dropped, 1);
+    return false;
+}
+
+bool EventQueue::push(const String& key, const String& value, uint8_t source) {
+    return push(key.c_str(), key.length(), value.c_str(), value.length(), source);
+}
+
+//разбор списка вида "key value,key value," без выделения памяти
+size_t EventQueue::pushList(const String& list, uint8_t source, size_t* lost) {
+    size_t count = 0;
+    size_t failed = 0;
+    const char* psn = list.c_str();
+    const char* end = psn + list.length();
+    while (psn < end) {
+        const char* comma = (const char*)memchr(psn, ',', end - psn);
+        if (!comma) {
+            comma = end;
+        }
+        while (psn < comma && *psn == ' ') {
+            psn++;
+        }
+        if (psn < comma) {
+            const char* space = (const char*)memchr(psn, ' ', comma - psn);
+            bool ok = space ? push(psn, space - psn, space + 1, comma - space - 1, source) : push(psn, comma - psn, "", 0, source);
+            if (ok) {
+                count++;
+            } else {
+                failed++;
+            }
+        }
+        psn = comma + 1;
+    }
+    if (lost) {
+        *lost = failed;
+    }
+    return count;
+}
+
+bool EventQueue::take(QueueRecord* rec) {
+    uint32_t pos = loadU32(&_dequeuePos);
+    while (true) {
+        Cell* cell = &_cells[pos & _mask];
+        int32_t dif = (int32_t)loadU32(&cell->seq) - (int32_t)(pos + 1);
+        if (dif == 0) {
+            if (casU32(&_dequeuePos, pos, pos + 1)) {
+                char* data = cell->data;
+                if (rec) {
+                    rec->keyId = KEY_UNKNOWN;  //номер ищет разбор в loop, таблица ключей может смениться
+                    rec->source = cell->source;
+                    rec->stamp = cell->stamp;
+                    rec->key = data;
+                    rec->value = data + cell->keyLen + 1;
+                }
+                storeU32(&cell->seq, pos + _mask + 1);
+                free(data);
+                return true;
+            }
+            pos = loadU32(&_dequeuePos);
+        } else if (dif < 0) {
+            return false;  //очередь пуста
+        } else {
+            pos = loadU32(&_dequeuePos);
+        }
+    }
+}
+
+bool EventQueue::pop(QueueRecord& rec) {
+    uint32_t depth = this->depth();
+    if (!take(&rec)) {
+        return false;
+    }
+    stats.done(millis() - rec.stamp, depth);
+    return true;
+}
+
+size_t EventQueue::depth() const {
+    return loadU32(&_enqueuePos) - loadU32(&_dequeuePos);
+}
+
+void EventQueue::statsToJson(JsonObject& root, const String& prefix) const {
+    root[prefix + "Depth"] = depth();
+    root[prefix + "MaxDepth"] = stats._maxDepth;
+    root[prefix + "Done"] = stats._processed;
+    root[prefix + "Dropped"] = stats._dropped;
+    root[prefix + "WaitMax"] = stats._waitMax_ms;
+    root[prefix + "WaitAvg"] = stats.waitAvg();
+}
@@ -0,0 +1,256 @@
+#include "Class/Gorilla.h"
+
+#define WINDOW_NONE 0xFF
+
+static inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float bitsFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline void putU32(uint8_t* buf, uint32_t value) {
+    buf[0] = value;
+    buf[1] = value >> 8;
+    buf[2] = value >> 16;
+    buf[3] = value >> 24;
+}
+
+static inline uint32_t getU32(const uint8_t* buf) {
+    return buf[0] | (buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+GorillaBlock::GorillaBlock() {
+    memset(_buf, 0, sizeof(_buf));
+    _bitPos = GORILLA_HEADER_SIZE * 8;
+    _prevTime = 0;
+    _prevDelta = 0;
+    _prevValue = 0;
+    _leading = WINDOW_NONE;
+    _trailing = 0;
+    _count = 0;
+}
+
+void GorillaBlock::begin(uint32_t time, float value) {
+    memset(_buf, 0, sizeof(_buf));
+    _prevTime = time;
+    _prevDelta = 0;
+    _prevValue = floatBits(value);
+    _leading = WINDOW_NONE;
+    _trailing = 0;
+    _count = 1;
+    _bitPos = GORILLA_HEADER_SIZE * 8;
+    putU32(_buf, time);
+    putU32(_buf + 4, _prevValue);
+    writeHeader();
+}
+
+void GorillaBlock::writeHeader() {
+    _buf[8] = _count;
+    _buf[9] = _count >> 8;
+    _buf[10] = _bitPos;
+    _buf[11] = _bitPos >> 8;
+}
+
+bool GorillaBlock::writeBits(uint32_t value, uint8_t bits) {
+    if (_bitPos + bits > LOG_BLOCK_SIZE * 8) {
+        return false;
+    }
+    while (bits--) {
+        uint8_t mask = 0x80 >> (_bitPos & 7);
+        if ((value >> bits) & 1) {
+            _buf[_bitPos >> 3] |= mask;
+        } else {
+            _buf[_bitPos >> 3] &= ~mask;
+        }
+        _bitPos++;
+    }
+    return true;
+}
+
+bool GorillaBlock::append(uint32_t time, float value) {
+    if (!_count) {
+        begin(time, value);
+        return true;
+    }
+    //при переполнении откатываемся к сохраненному состоянию
+    uint32_t savedPos = _bitPos;
+    uint8_t savedLeading = _leading;
+    uint8_t savedTrailing = _trailing;
+
+    int32_t delta = (int32_t)(time - _prevTime);
+    int32_t dod = delta - _prevDelta;
+    bool ok;
+    if (dod == 0) {
+        ok = writeBits(0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        ok = writeBits(0x2, 2) && writeBits(dod + 63, 7);
+    } else if (dod >= -255 && dod <= 256) {
+        ok = writeBits(0x6, 3) && writeBits(dod + 255, 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        ok = writeBits(0xE, 4) && writeBits(dod + 2047, 12);
+    } else {
+        ok = writeBits(0xF, 4) && writeBits((uint32_t)dod, 32);
+    }
+
+    uint32_t bits = floatBits(value);
+    uint32_t x = bits ^ _prevValue;
+    if (ok) {
+        if (!x) {
+            ok = writeBits(0, 1);
+        } else {
+            uint8_t leading = __builtin_clz(x);
+            uint8_t trailing = __builtin_ctz(x);
+            if (leading > 31) {
+                leading = 31;
+            }
+            if (_leading != WINDOW_NONE && leading >= _leading && trailing >= _trailing) {
+                //значащие биты помещаются в окно предыдущего значения
+                ok = writeBits(0x2, 2) && writeBits(x >> _trailing, 32 - _leading - _trailing);
+            } else {
+                uint8_t len = 32 - leading - trailing;
+                ok = writeBits(0x3, 2) && writeBits(leading, 5) && writeBits(len - 1, 5) && writeBits(x >> trailing, len);
+                if (ok) {
+                    _leading = leading;
+                    _trailing = trailing;
+                }
+            }
+        }
+    }
+
+    if (!ok) {
+        _bitPos = savedPos;
+        _leading = savedLeading;
+        _trailing = savedTrailing;
+        return false;
+    }
+    _prevTime = time;
+    _prevDelta = delta;
+    _prevValue = bits;
+    _count++;
+    writeHeader();
+    return true;
+}
+
+bool GorillaBlock::resume() {
+    GorillaDecoder decoder(_buf, LOG_BLOCK_SIZE);
+    uint32_t time;
+    float value;
+    uint16_t n = 0;
+    while (decoder.next(time, value)) {
+        n++;
+    }
+    if (n != decoder.count()) {
+        return false;
+    }
+    decoder.saveState(*this);
+    return true;
+}
+
+GorillaDecoder::GorillaDecoder(const uint8_t* buf, size_t size) {
+    _buf = buf;
+    _size = size;
+    _bitPos = GORILLA_HEADER_SIZE * 8;
+    _prevTime = getU32(buf);
+    _prevDelta = 0;
+    _prevValue = getU32(buf + 4);
+    _leading = WINDOW_NONE;
+    _trailing = 0;
+    _count = buf[8] | (buf[9] << 8);
+    _read = 0;
+}
+
+bool GorillaDecoder::readBits(uint32_t& value, uint8_t bits) {
+    if (_bitPos + bits > _size * 8) {
+        return false;
+    }
+    value = 0;
+    while (bits--) {
+        value = (value << 1) | ((_buf[_bitPos >> 3] >> (7 - (_bitPos & 7))) & 1);
+        _bitPos++;
+    }
+    return true;
+}
+
+bool GorillaDecoder::next(uint32_t& time, float& value) {
+    if (_read >= _count) {
+        return false;
+    }
+    if (_read == 0) {
+        _read++;
+        time = _prevTime;
+        value = bitsFloat(_prevValue);
+        return true;
+    }
+
+    //префикс разности разностей: 0, 10, 110, 1110, 1111
+    uint8_t ones = 0;
+    uint32_t bit;
+    while (ones < 4) {
+        if (!readBits(bit, 1)) {
+            return false;
+        }
+        if (!bit) {
+            break;
+        }
+        ones++;
+    }
+    static const uint8_t dodBits[] = {0, 7, 9, 12, 32};
+    static const int32_t dodBias[] = {0, 63, 255, 2047, 0};
+    int32_t dod = 0;
+    if (ones) {
+        uint32_t raw;
+        if (!readBits(raw, dodBits[ones])) {
+            return false;
+        }
+        dod = (int32_t)raw - dodBias[ones];
+    }
+
+    uint32_t x = 0;
+    if (!readBits(bit, 1)) {
+        return false;
+    }
+    if (bit) {
+        if (!readBits(bit, 1)) {
+            return false;
+        }
+        if (bit) {
+            uint32_t leading, len;
+            if (!readBits(leading, 5) || !readBits(len, 5)) {
+                return false;
+            }
+            _leading = leading;
+            _trailing = 32 - leading - (len + 1);
+        } else if (_leading == WINDOW_NONE) {
+            return false;  //окна еще не было - блок испорчен
+        }
+        uint32_t meaningful;
+        if (!readBits(meaningful, 32 - _leading - _trailing)) {
+            return false;
+        }
+        x = meaningful << _trailing;
+    }
+
+    _prevDelta += dod;
+    _prevTime += _prevDelta;
+    _prevValue ^= x;
+    _read++;
+    time = _prevTime;
+    value = bitsFloat(_prevValue);
+    return true;
+}
+
+void GorillaDecoder::saveState(GorillaBlock& block) const {
+    block._bitPos = _bitPos;
+    block._prevTime = _prevTime;
+    block._prevDelta = _prevDelta;
+    block._prevValue = _prevValue;
+    block._leading = _leading;
+    block._trailing = _trailing;
+    block._count = _count;
+}
@@ -0,0 +1,117 @@
+#include "Class/ItemScheduler.h"
+
+#include <algorithm>
+
+#include "Global.h"
+
+ItemScheduler itemScheduler;
+
+//сравнение сроков с учетом переполнения millis()
+bool ItemScheduler::later(const Entry& a, const Entry& b) {
+    return (long)(a.deadline - b.deadline) > 0;
+}
+
+void ItemScheduler::addList(void* vector, ListSize_t size, ListItem_t item) {
+    for (size_t i = 0; i < _lists.size(); i++) {
+        if (_lists[i].vector == vector) {
+            return;
+        }
+    }
+    List list = {vector, size, item, 0};
+    _lists.push_back(list);
+    sync();
+}
+
+//новые элементы в конце векторов встают в расписание, вектор стал короче - его элементы ставятся заново
+void ItemScheduler::sync() {
+    for (size_t l = 0; l < _lists.size(); l++) {
+        List& list = _lists[l];
+        size_t size = list.size(list.vector);
+        if (size < list.known) {
+            drop(l);
+        }
+        unsigned long now = millis();
+        for (; list.known < size; list.known++) {
+            Entry entry = {(uint16_t)l, (uint16_t)list.known, now, 0, 0, 0};
+            unsigned long interval = item(entry)->interval();
+            if (interval == ITEM_PASSIVE) {
+                continue;
+            }
+            if (interval == 0) {
+                _polled.push_back(entry);
+            } else {
+                entry.deadline = now + (_heap.size() * ITEM_STAGGER_MS) % interval;
+                _heap.push_back(entry);
+                std::push_heap(_heap.begin(), _heap.end(), later);
+            }
+        }
+    }
+}
+
+void ItemScheduler::drop(uint16_t list) {
+    for (int v = 0; v < 2; v++) {
+        std::vector<Entry>& entries = v ? _heap : _polled;
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [list](const Entry& entry) { return entry.list == list; }), entries.end());
+    }
+    std::make_heap(_heap.begin(), _heap.end(), later);
+    _lists[list].known = 0;
+}
+
+void ItemScheduler::clear() {
+    _heap.clear();
+    _polled.clear();
+    for (size_t i = 0; i < _lists.size(); i++) {
+        _lists[i].known = 0;
+    }
+}
+
+void ItemScheduler::run(Entry& entry) {
+    unsigned long start = micros();
+    item(entry)->loop();
+    uint32_t time = micros() - start;
+    entry.runs++;
+    entry.totalMu += time;
+    if (entry.maxMu < time) {
+        entry.maxMu = time;
+    }
+}
+
+void ItemScheduler::loop() {
+    sync();
+    for (size_t i = 0; i < _polled.size(); i++) {
+        run(_polled[i]);
+    }
+
+    unsigned long now = millis();
+    while (!_heap.empty() && (long)(now - _heap.front().deadline) >= 0) {
+        std::pop_heap(_heap.begin(), _heap.end(), later);
+        Entry& entry = _heap.back();
+        run(entry);
+        entry.deadline = now + item(entry)->interval();
+        std::push_heap(_heap.begin(), _heap.end(), later);
+    }
+
+    if (now - _statsMillis >= ITEM_STATS_INTERVAL) {
+        _statsMillis = now;
+        updateStats();
+    }
+}
+
+//снимок статистики для веб сервера готовится здесь, в loop, а не в асинхронном обработчике
+void ItemScheduler::updateStats() {
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.createObject();
+    for (int list = 0; list < 2; list++) {
+        const std::vector<Entry>& entries = list ? _heap : _polled;
+        for (size_t i = 0; i < entries.size(); i++) {
+            const Entry& entry = entries[i];
+            JsonObject& stats = root.createNestedObject(item(entry)->itemKey());
+            stats["interval"] = item(entry)->interval();
+            stats["runs"] = entry.runs;
+            stats["avgMu"] = entry.runs ? entry.totalMu / entry.runs : 0;
+            stats["maxMu"] = entry.maxMu;
+        }
+    }
+    _statsJson = "";
+    root.printTo(_statsJson);
+}
@@ -0,0 +1,44 @@
+#include "Class/KeyTable.h"
+
+#include "Utils/SerialPrint.h"
+
+KeyTable keyTable;
+
+uint16_t KeyTable::find(const char* key, size_t len) const {
+    size_t count = size();
+    for (size_t i = 0; i < count; i++) {
+        const String& name = this->name(i);
+        if (name.length() == len && !memcmp(name.c_str(), key, len)) {
+            return i;
+        }
+    }
+    return KEY_UNKNOWN;
+}
+
+uint16_t KeyTable::find(const String& key) const {
+    return find(key.c_str(), key.length());
+}
+
+void KeyTable::clear() {
+    __atomic_store_n(&_count, 0, __ATOMIC_RELEASE);
+}
+
+uint16_t KeyTable::intern(const String& key) {
+    uint16_t id = find(key);
+    if (id != KEY_UNKNOWN) {
+        return id;
+    }
+    size_t count = size();
+    if (count >= KEY_CHUNKS * KEY_CHUNK_SIZE) {
+        SerialPrint("E", "KeyTable", "table full, key: " + key);
+        return KEY_UNKNOWN;
+    }
+    String*& chunk = _chunks[count / KEY_CHUNK_SIZE];
+    if (!chunk) {
+        chunk = new String[KEY_CHUNK_SIZE];
+    }
+    chunk[count % KEY_CHUNK_SIZE] = key;
+    //номер становится виден другим задачам только после записи ключа
+    __atomic_store_n(&_count, count + 1, __ATOMIC_RELEASE);
+    return count;
+}
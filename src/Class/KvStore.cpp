@@ -0,0 +1,234 @@
+#include "Class/KvStore.h"
+
+#include "Utils/FileUtils.h"
+#include "Utils/SerialPrint.h"
+
+#define KV_MAGIC 0xA5
+#define KV_REMOVED 0xFFFF
+#define KV_TMP_FILE "/kv.tmp"
+
+KvStore kvStore;
+
+struct KvHeader {
+    uint8_t magic;
+    uint8_t keyLen;
+    uint16_t valueLen;  //KV_REMOVED - ключ удален
+    uint32_t crc;
+};
+
+static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static size_t recordSize(const String& key, const String& value) {
+    return sizeof(KvHeader) + key.length() + value.length();
+}
+
+void KvStore::begin() {
+    //компактирование прервалось после удаления журнала - новый журнал уже полностью записан
+    if (!FileFS.exists(KV_STORE_FILE) && FileFS.exists(KV_TMP_FILE)) {
+        FileFS.rename(KV_TMP_FILE, KV_STORE_FILE);
+    }
+    if (FileFS.exists(KV_TMP_FILE)) {
+        FileFS.remove(KV_TMP_FILE);
+    }
+
+    bool fresh = !FileFS.exists(KV_STORE_FILE);
+    if (!load()) {
+        SerialPrint("E", "KvStore", "broken tail dropped");
+        compact();
+    }
+
+    //первый запуск - переносим старые счетчики из отдельных файлов
+    if (fresh) {
+        importFile("stat.txt");
+        importFile("totalhrs.txt");
+        importFile("order.txt");
+        importFile("pins.txt");
+    }
+    SerialPrint("I", "KvStore", "keys: " + String(_values.size()) + ", log: " + String(_logSize));
+}
+
+bool KvStore::load() {
+    _values.clear();
+    _logSize = 0;
+    _liveSize = 0;
+    File file = FileFS.open(KV_STORE_FILE, FILE_READ);
+    if (!file) {
+        return true;
+    }
+    size_t size = file.size();
+    bool ok = true;
+    char key[256];
+    while (_logSize < size) {
+        KvHeader hdr;
+        if (file.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) || hdr.magic != KV_MAGIC) {
+            ok = false;
+            break;
+        }
+        size_t valueLen = hdr.valueLen == KV_REMOVED ? 0 : hdr.valueLen;
+        if (_logSize + sizeof(hdr) + hdr.keyLen + valueLen > size) {
+            ok = false;
+            break;
+        }
+        file.read((uint8_t*)key, hdr.keyLen);
+        key[hdr.keyLen] = '\0';
+        String value;
+        value.reserve(valueLen);
+        for (size_t i = 0; i < valueLen; i++) {
+            value += (char)file.read();
+        }
+        uint32_t crc = crc32(0, (const uint8_t*)key, hdr.keyLen);
+        crc = crc32(crc, (const uint8_t*)value.c_str(), valueLen);
+        if (crc != hdr.crc) {
+            ok = false;
+            break;
+        }
+        if (hdr.valueLen == KV_REMOVED) {
+            _values.erase(key);
+        } else {
+            _values[key] = value;
+        }
+        _logSize += sizeof(hdr) + hdr.keyLen + valueLen;
+    }
+    file.close();
+    for (auto& kv : _values) {
+        _liveSize += recordSize(kv.first, kv.second);
+    }
+    return ok;
+}
+
+bool KvStore::append(File& file, const String& key, const String& value, bool removed) {
+    if (key.length() > 255 || value.length() >= KV_REMOVED) {
+        SerialPrint("E", "KvStore", "too long: " + key);
+        return false;
+    }
+    KvHeader hdr;
+    hdr.magic = KV_MAGIC;
+    hdr.keyLen = key.length();
+    hdr.valueLen = removed ? KV_REMOVED : value.length();
+    hdr.crc = crc32(0, (const uint8_t*)key.c_str(), key.length());
+    hdr.crc = crc32(hdr.crc, (const uint8_t*)value.c_str(), removed ? 0 : value.length());
+    size_t len = file.write((const uint8_t*)&hdr, sizeof(hdr));
+    len += file.write((const uint8_t*)key.c_str(), key.length());
+    if (!removed) {
+        len += file.write((const uint8_t*)value.c_str(), value.length());
+    }
+    return len == sizeof(hdr) + key.length() + (removed ? 0 : value.length());
+}
+
+bool KvStore::has(const String& key) const {
+    return _values.find(key) != _values.end();
+}
+
+String KvStore::get(const String& key) const {
+    auto it = _values.find(key);
+    return it == _values.end() ? String() : it->second;
+}
+
+int KvStore::getInt(const String& key) const {
+    return get(key).toInt();
+}
+
+//запись в конец журнала; при ошибке журнал переписывается из памяти, где этой записи еще нет
+bool KvStore::appendLog(const String& key, const String& value, bool removed) {
+    if (_torn && !compact()) {
+        return false;
+    }
+    File file = FileFS.open(KV_STORE_FILE, FILE_APPEND);
+    if (!file) {
+        SerialPrint("E", "KvStore", "open " + String(KV_STORE_FILE));
+        return false;
+    }
+    bool ok = append(file, key, value, removed);
+    file.close();
+    if (!ok) {
+        SerialPrint("E", "KvStore", "write failed: " + key);
+        _torn = true;
+        compact();
+        return false;
+    }
+    _logSize += recordSize(key, removed ? "" : value);
+    return true;
+}
+
+bool KvStore::set(const String& key, const String& value) {
+    auto it = _values.find(key);
+    if (it != _values.end() && it->second == value) {
+        return true;
+    }
+    if (!appendLog(key, value, false)) {
+        return false;
+    }
+    if (it != _values.end()) {
+        _liveSize -= recordSize(key, it->second);
+    }
+    _values[key] = value;
+    _liveSize += recordSize(key, value);
+    if (_logSize > KV_COMPACT_SIZE && _logSize > 2 * _liveSize) {
+        compact();
+    }
+    return true;
+}
+
+int KvStore::increment(const String& key) {
+    int number = getInt(key) + 1;
+    set(key, String(number));
+    return number;
+}
+
+bool KvStore::remove(const String& key) {
+    auto it = _values.find(key);
+    if (it == _values.end()) {
+        return true;
+    }
+    if (!appendLog(key, "", true)) {
+        return false;
+    }
+    _liveSize -= recordSize(key, it->second);
+    _values.erase(it);
+    return true;
+}
+
+//новый журнал пишется рядом и заменяет старый, только если записан целиком
+bool KvStore::compact() {
+    File file = FileFS.open(KV_TMP_FILE, FILE_WRITE);
+    if (!file) {
+        SerialPrint("E", "KvStore", "open " + String(KV_TMP_FILE));
+        return false;
+    }
+    bool ok = true;
+    for (auto& kv : _values) {
+        if (!append(file, kv.first, kv.second, false)) {
+            ok = false;
+            break;
+        }
+    }
+    file.close();
+    if (!ok) {
+        SerialPrint("E", "KvStore", "compact failed");
+        FileFS.remove(KV_TMP_FILE);
+        return false;
+    }
+    //SPIFFS не переименовывает поверх существующего файла
+    FileFS.remove(KV_STORE_FILE);
+    FileFS.rename(KV_TMP_FILE, KV_STORE_FILE);
+    _logSize = _liveSize;
+    _torn = false;
+    return true;
+}
+
+void KvStore::importFile(const String& filename) {
+    if (!FileFS.exists("/" + filename)) {
+        return;
+    }
+    set(filename, readFile(filename, 100));
+    removeFile(filename);
+}
@@ -0,0 +1,76 @@
+#include "Consts.h"
+#ifdef EnableLogging
+#include "Class/LogQuery.h"
+
+#include <ESPAsyncWebServer.h>
+#ifndef ESP8266
+#include <mutex>
+#endif
+
+#include "Class/Lttb.h"
+#include "items/vLogging.h"
+
+static std::vector<std::shared_ptr<LogQuery>> pending;
+#ifndef ESP8266
+static std::mutex pendingMutex;
+#endif
+
+LogQuery::LogQuery(const String& key, uint32_t from, uint32_t to, size_t points) {
+    _key = key;
+    _from = from;
+    _to = to;
+    _points = points;
+}
+
+void LogQuery::run() {
+    LoggingClass* item = myLogging != nullptr ? myLogging->find(_key) : nullptr;
+    if (item != nullptr) {
+        uint32_t from = _from;
+        uint32_t to = _to;
+        Lttb::downsample([item, from, to](RingLogHandler_t handler) {
+            item->forEachInRange(from, to, [&handler](const RollupRecord& rec) {
+                RingLogRecord point = {rec.time, rec.avg};
+                handler(point);
+            });
+        }, _points, _result);
+    }
+    __atomic_store_n(&_ready, true, __ATOMIC_RELEASE);
+}
+
+size_t LogQuery::fill(uint8_t* buf, size_t maxLen) {
+    if (!__atomic_load_n(&_ready, __ATOMIC_ACQUIRE)) {
+        return RESPONSE_TRY_AGAIN;
+    }
+    if (!_filler) {
+        _filler.reset(new ChartFiller(_result));
+    }
+    return _filler->fill(buf, maxLen);
+}
+
+bool logQueryAdd(std::shared_ptr<LogQuery> query) {
+#ifndef ESP8266
+    std::lock_guard<std::mutex> lock(pendingMutex);
+#endif
+    if (pending.size() >= LOG_QUERY_PENDING) {
+        return false;
+    }
+    pending.push_back(query);
+    return true;
+}
+
+//по одному запросу за проход loop
+void logQueriesLoop() {
+    std::shared_ptr<LogQuery> query;
+    {
+#ifndef ESP8266
+        std::lock_guard<std::mutex> lock(pendingMutex);
+#endif
+        if (pending.empty()) {
+            return;
+        }
+        query = pending.front();
+        pending.erase(pending.begin());
+    }
+    query->run();
+}
+#endif
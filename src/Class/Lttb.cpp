@@ -0,0 +1,118 @@
+#include "Class/Lttb.h"
+
+struct LttbBucket {
+    float time;  //от первой точки, чтобы хватило точности float
+    float value;
+    uint32_t count;
+};
+
+void Lttb::downsample(LttbSource_t source, size_t points, std::vector<RingLogRecord>& out) {
+    out.clear();
+    if (!points) {
+        return;
+    }
+
+    //первый проход: границы и число точек
+    size_t total = 0;
+    RingLogRecord first = {0, 0};
+    RingLogRecord last = {0, 0};
+    source([&](const RingLogRecord& rec) {
+        if (!total) {
+            first = rec;
+        }
+        last = rec;
+        total++;
+    });
+    if (total <= points) {
+        out.reserve(total);
+        source([&out](const RingLogRecord& rec) {
+            out.push_back(rec);
+        });
+        return;
+    }
+    //на интервалы делить нечего: одна точка - последняя, две - края
+    if (points < 3 || last.time <= first.time) {
+        if (points > 1) {
+            out.push_back(first);
+        }
+        out.push_back(last);
+        return;
+    }
+
+    size_t count = points - 2;
+    uint32_t span = last.time - first.time;
+    auto bucketOf = [count, span, &first](uint32_t time) -> size_t {
+        size_t idx = (uint64_t)(time - first.time) * count / span;
+        return idx < count ? idx : count - 1;
+    };
+
+    //второй проход: средние по интервалам
+    std::vector<LttbBucket> buckets(count, LttbBucket{0, 0, 0});
+    size_t seen = 0;
+    source([&](const RingLogRecord& rec) {
+        seen++;
+        if (seen == 1 || seen == total || rec.time < first.time) {
+            return;
+        }
+        LttbBucket& bucket = buckets[bucketOf(rec.time)];
+        bucket.count++;
+        bucket.time += ((rec.time - first.time) - bucket.time) / bucket.count;
+        bucket.value += (rec.value - bucket.value) / bucket.count;
+    });
+    //пустой интервал смотрит на следующий непустой, за последним - последняя точка
+    LttbBucket next = {(float)span, last.value, 1};
+    for (size_t i = count; i > 0; i--) {
+        if (buckets[i - 1].count) {
+            next = buckets[i - 1];
+        } else {
+            buckets[i - 1] = next;
+            buckets[i - 1].count = 0;
+        }
+    }
+
+    //третий проход: выбор точек
+    out.reserve(points);
+    out.push_back(first);
+    float prevTime = 0;
+    float prevValue = first.value;
+    size_t current = 0;
+    bool hasBest = false;
+    float bestArea = -1;
+    RingLogRecord best = first;
+    seen = 0;
+    auto emit = [&]() {
+        if (hasBest) {
+            out.push_back(best);
+            prevTime = best.time - first.time;
+            prevValue = best.value;
+            hasBest = false;
+            bestArea = -1;
+        }
+    };
+    source([&](const RingLogRecord& rec) {
+        seen++;
+        if (seen == 1 || seen == total || rec.time < first.time) {
+            return;
+        }
+        size_t idx = bucketOf(rec.time);
+        if (idx != current) {
+            emit();
+            current = idx;
+        }
+        float nextTime = (float)span;
+        float nextValue = last.value;
+        if (idx + 1 < count) {
+            nextTime = buckets[idx + 1].time;
+            nextValue = buckets[idx + 1].value;
+        }
+        float time = rec.time - first.time;
+        float area = fabs((prevTime - nextTime) * (rec.value - prevValue) - (prevTime - time) * (nextValue - prevValue));
+        if (area > bestArea) {
+            bestArea = area;
+            best = rec;
+            hasBest = true;
+        }
+    });
+    emit();
+    out.push_back(last);
+}
@@ -0,0 +1,186 @@
+#include "Class/MqttLimiter.h"
+
+#include "Class/Settings.h"
+#include "Global.h"
+#include "MqttClient.h"
+
+MqttLimiter mqttLimiter;
+
+//за минуту (предел elapsed) прибавляется rate * MQTT_RATE_UNIT, емкость корзины меньше
+static_assert((uint64_t)MQTT_RATE_MAX * MQTT_RATE_UNIT <= UINT32_MAX, "MQTT_RATE_MAX overflows bucket level");
+
+const char* MqttLimiter::className(uint8_t cls) {
+    static const char* names[MC_COUNT] = {"status", "event", "chart", "config", "device"};
+    return cls < MC_COUNT ? names[cls] : "";
+}
+
+//уровень в долях токена: за мс прибавляется mqttRate (сообщений в минуту), токен - MQTT_RATE_UNIT
+void MqttLimiter::refill(uint8_t cls) {
+    Bucket& bucket = _buckets[cls];
+    uint32_t rate = settings.mqttRate[cls];
+    if (rate > MQTT_RATE_MAX) {
+        rate = MQTT_RATE_MAX;
+    }
+    uint32_t burst = rate * MQTT_RATE_BURST_S / 60;
+    if (!burst) {
+        burst = 1;
+    }
+    uint32_t capacity = burst * MQTT_RATE_UNIT;
+    unsigned long now = millis();
+    if (!bucket.started) {
+        bucket.started = true;
+        bucket.stamp = now;
+        bucket.level = capacity;
+        return;
+    }
+    uint32_t elapsed = now - bucket.stamp;
+    bucket.stamp = now;
+    if (elapsed > MQTT_RATE_UNIT) {
+        elapsed = MQTT_RATE_UNIT;  //за минуту любая корзина уже полна, дальше только переполнение
+    }
+    uint32_t add = elapsed * rate;
+    bucket.level = bucket.level < capacity && capacity - bucket.level > add ? bucket.level + add : capacity;
+}
+
+bool MqttLimiter::available(uint8_t cls) {
+    refill(MC_DEVICE);
+    if (cls != MC_DEVICE) {
+        refill(cls);
+        if (_buckets[cls].level < MQTT_RATE_UNIT) {
+            return false;
+        }
+    }
+    return _buckets[MC_DEVICE].level >= MQTT_RATE_UNIT;
+}
+
+void MqttLimiter::consume(uint8_t cls) {
+    if (cls != MC_DEVICE) {
+        Bucket& bucket = _buckets[cls];
+        bucket.level = bucket.level > MQTT_RATE_UNIT ? bucket.level - MQTT_RATE_UNIT : 0;
+    }
+    Bucket& device = _buckets[MC_DEVICE];
+    device.level = device.level > MQTT_RATE_UNIT ? device.level - MQTT_RATE_UNIT : 0;
+}
+
+bool MqttLimiter::take(MqttClass_t cls) {
+    if (_bypass) {
+        return true;
+    }
+    if (available(cls)) {
+        consume(cls);
+        return true;
+    }
+    _throttled[_buckets[cls].level < MQTT_RATE_UNIT ? cls : MC_DEVICE]++;
+    return false;
+}
+
+bool MqttLimiter::ready(MqttClass_t cls) {
+    return available(cls);
+}
+
+void MqttLimiter::charge(MqttClass_t cls) {
+    refill(MC_DEVICE);
+    refill(cls);
+    consume(cls);
+}
+
+bool MqttLimiter::pending(const char* topic, const char* key) const {
+    if (!_count) {
+        return false;
+    }
+    for (size_t i = 0; i < MQTT_DEFER_SIZE; i++) {
+        const Slot& slot = _slots[i];
+        if (slot.used && slot.topic == topic && slot.key == (key ? key : "")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MqttLimiter::defer(MqttClass_t cls, const char* topic, const String& payload, bool retain, const char* key) {
+    if (!key) {
+        key = "";
+    }
+    Slot* empty = nullptr;
+    for (size_t i = 0; i < MQTT_DEFER_SIZE; i++) {
+        Slot& slot = _slots[i];
+        if (!slot.used) {
+            if (!empty) {
+                empty = &slot;
+            }
+        } else if (slot.topic == topic && slot.key == key) {
+            slot.payload = payload;
+            slot.retain = retain;
+            _collapsed++;
+            return true;
+        }
+    }
+    if (!empty) {
+        _dropped++;
+        return false;
+    }
+    empty->topic = topic;
+    empty->payload = payload;
+    empty->key = key;
+    empty->cls = cls;
+    empty->retain = retain;
+    empty->used = true;
+    _count++;
+    return true;
+}
+
+void MqttLimiter::loop() {
+    if (_count && mqtt.connected()) {
+        for (size_t n = 0; n < MQTT_DEFER_SIZE && _count; n++) {
+            size_t i = (_next + n) % MQTT_DEFER_SIZE;
+            Slot& slot = _slots[i];
+            if (!slot.used || !available(slot.cls)) {
+                continue;
+            }
+            consume(slot.cls);
+            if (!publish(slot.topic.c_str(), slot.payload.c_str(), slot.payload.length(), slot.retain)) {
+                break;
+            }
+            slot.used = false;
+            slot.topic = "";
+            slot.payload = "";
+            _count--;
+            _sent++;
+            _next = i + 1;
+        }
+    }
+    if (millis() - _diagAt >= MQTT_DIAG_INTERVAL) {
+        _diagAt = millis();
+        publishDiag();
+    }
+}
+
+//отправляется только если с прошлого раза что-то задерживалось
+void MqttLimiter::publishDiag() {
+    uint32_t total = _dropped;
+    for (uint8_t i = 0; i < MC_COUNT; i++) {
+        total += _throttled[i];
+    }
+    if (total == _diagLast || !mqtt.connected()) {
+        return;
+    }
+    String json = "{";
+    for (uint8_t i = 0; i < MC_COUNT; i++) {
+        json += "\"" + String(className(i)) + "\":" + String(_throttled[i]) + ",";
+    }
+    json += "\"collapsed\":" + String(_collapsed) + ",\"dropped\":" + String(_dropped) + "}";
+    String topic = mqttRootDevice + "/diag";
+    if (publish(topic.c_str(), json.c_str(), json.length())) {
+        _diagLast = total;
+    }
+}
+
+void MqttLimiter::statsToJson(JsonObject& root) const {
+    for (uint8_t i = 0; i < MC_COUNT; i++) {
+        root["mqttThrottled" + String(className(i))] = _throttled[i];
+    }
+    root["mqttDeferDepth"] = depth();
+    root["mqttDeferSent"] = _sent;
+    root["mqttDeferCollapsed"] = _collapsed;
+    root["mqttDeferDropped"] = _dropped;
+}
@@ -0,0 +1,190 @@
+#include "Class/MqttOutbox.h"
+
+#include "Class/MqttLimiter.h"
+#include "Global.h"
+#include "MqttClient.h"
+#include "Utils/SerialPrint.h"
+
+MqttOutbox mqttOutbox;
+
+#define MQTT_SPOOL_RECORD_MAGIC 0xA7
+
+//файл от прошлого запуска отправляется с сохраненной позиции
+void MqttOutbox::begin() {
+    File file = FileFS.open(MQTT_SPOOL_FILE, FILE_READ);
+    if (!file) {
+        return;
+    }
+    MqttSpoolHeader hdr;
+    bool ok = file.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) && hdr.magic == MQTT_SPOOL_MAGIC;
+    _spoolSize = file.size();
+    file.close();
+    if (!ok || hdr.readPos < sizeof(hdr) || hdr.readPos >= _spoolSize) {
+        dropSpool();
+        return;
+    }
+    _spoolRead = hdr.readPos;
+    _spooled = true;
+    SerialPrint("I", "MQTT", "outbox: " + String(_spoolSize - _spoolRead) + " bytes to send");
+}
+
+//статус схлопывается с ожидающим в памяти и тогда, когда уже пишется файл:
+//в файле этого топика быть не может, он попал бы в ту же запись в памяти
+bool MqttOutbox::add(const char* topic, const String& payload, bool retain, const char* key) {
+    _queued++;
+    if (key) {
+        for (size_t i = 0; i < _count; i++) {
+            Entry& entry = _ram[(_head + i) % MQTT_OUTBOX_SIZE];
+            if (entry.key == key && entry.topic == topic) {
+                entry.payload = payload;
+                _coalesced++;
+                return true;
+            }
+        }
+    }
+    if (_spooled || _count == MQTT_OUTBOX_SIZE) {
+        return spill(topic, payload, retain);
+    }
+    Entry& entry = _ram[(_head + _count) % MQTT_OUTBOX_SIZE];
+    entry.topic = topic;
+    entry.payload = payload;
+    entry.key = key ? key : "";
+    entry.retain = retain;
+    _count++;
+    return true;
+}
+
+bool MqttOutbox::spill(const char* topic, const String& payload, bool retain) {
+    size_t topicLen = strlen(topic);
+    size_t size = sizeof(MqttSpoolRecord) + topicLen + payload.length();
+    if (topicLen > 0xFF || payload.length() > 0xFFFF || (_spooled ? _spoolSize : sizeof(MqttSpoolHeader)) + size > MQTT_SPOOL_MAX) {
+        _dropped++;
+        return false;
+    }
+    if (!_spooled) {
+        File file = FileFS.open(MQTT_SPOOL_FILE, FILE_WRITE);
+        if (!file) {
+            _dropped++;
+            return false;
+        }
+        MqttSpoolHeader hdr = {MQTT_SPOOL_MAGIC, sizeof(MqttSpoolHeader)};
+        file.write((const uint8_t*)&hdr, sizeof(hdr));
+        file.close();
+        _spooled = true;
+        _spoolRead = sizeof(hdr);
+        _spoolSize = sizeof(hdr);
+    }
+    File file = FileFS.open(MQTT_SPOOL_FILE, FILE_APPEND);
+    if (!file) {
+        _dropped++;
+        return false;
+    }
+    MqttSpoolRecord rec = {MQTT_SPOOL_RECORD_MAGIC, retain, (uint8_t)topicLen, 0, (uint16_t)payload.length()};
+    bool ok = file.write((const uint8_t*)&rec, sizeof(rec)) == sizeof(rec) &&
+              file.write((const uint8_t*)topic, topicLen) == topicLen &&
+              file.write((const uint8_t*)payload.c_str(), payload.length()) == payload.length();
+    file.close();
+    if (!ok) {
+        _dropped++;
+        return false;
+    }
+    _spoolSize += size;
+    _spilled++;
+    return true;
+}
+
+void MqttOutbox::dropSpool() {
+    FileFS.remove(MQTT_SPOOL_FILE);
+    _spooled = false;
+    _spoolRead = 0;
+    _spoolSize = 0;
+}
+
+//отправка записей из файла, позиция сохраняется в заголовке после каждой пачки
+bool MqttOutbox::replaySpool() {
+    File file = FileFS.open(MQTT_SPOOL_FILE, "r+");
+    if (!file) {
+        dropSpool();
+        return false;
+    }
+    bool sent = true;
+    file.seek(_spoolRead, SeekSet);
+    for (uint8_t i = 0; i < MQTT_OUTBOX_BURST && _spoolRead < _spoolSize && mqttLimiter.ready(MC_DEVICE); i++) {
+        MqttSpoolRecord rec;
+        char topic[0x100];
+        if (file.read((uint8_t*)&rec, sizeof(rec)) != sizeof(rec) || rec.magic != MQTT_SPOOL_RECORD_MAGIC ||
+            file.read((uint8_t*)topic, rec.topicLen) != rec.topicLen) {
+            SerialPrint("E", "MQTT", "outbox: broken " + String(MQTT_SPOOL_FILE));
+            _spoolRead = _spoolSize;
+            break;
+        }
+        topic[rec.topicLen] = '\0';
+        //тело пишется в mqtt прямо из файла кусками
+        if (!mqtt.beginPublish(topic, rec.payloadLen, rec.retain)) {
+            sent = false;
+            break;
+        }
+        uint8_t buf[64];
+        size_t left = rec.payloadLen;
+        while (left) {
+            size_t part = file.read(buf, left < sizeof(buf) ? left : sizeof(buf));
+            if (!part) {
+                break;
+            }
+            mqtt.write(buf, part);
+            left -= part;
+        }
+        if (!mqtt.endPublish() || left) {
+            sent = false;
+            break;
+        }
+        _spoolRead += sizeof(rec) + rec.topicLen + rec.payloadLen;
+        _replayed++;
+        mqttLimiter.charge(MC_DEVICE);
+    }
+    if (_spoolRead >= _spoolSize) {
+        file.close();
+        dropSpool();
+        return sent;
+    }
+    MqttSpoolHeader hdr = {MQTT_SPOOL_MAGIC, _spoolRead};
+    file.seek(0, SeekSet);
+    file.write((const uint8_t*)&hdr, sizeof(hdr));
+    file.close();
+    return sent;
+}
+
+void MqttOutbox::loop() {
+    if (empty() || !mqtt.connected()) {
+        return;
+    }
+    //накопленное отправляется в пределах общего лимита устройства
+    for (uint8_t i = 0; i < MQTT_OUTBOX_BURST && _count; i++) {
+        if (!mqttLimiter.ready(MC_DEVICE)) {
+            return;
+        }
+        Entry& entry = _ram[_head];
+        if (!publish(entry.topic.c_str(), entry.payload.c_str(), entry.payload.length(), entry.retain)) {
+            return;
+        }
+        entry.topic = "";
+        entry.payload = "";
+        _head = (_head + 1) % MQTT_OUTBOX_SIZE;
+        _count--;
+        _replayed++;
+        mqttLimiter.charge(MC_DEVICE);
+    }
+    if (!_count && _spooled && mqttLimiter.ready(MC_DEVICE)) {
+        replaySpool();
+    }
+}
+
+void MqttOutbox::statsToJson(JsonObject& root) const {
+    root["outboxDepth"] = depth();
+    root["outboxSpool"] = spoolSize();
+    root["outboxQueued"] = _queued;
+    root["outboxCoalesced"] = _coalesced;
+    root["outboxSpilled"] = _spilled;
+    root["outboxDropped"] = _dropped;
+    root["outboxReplayed"] = _replayed;
+}
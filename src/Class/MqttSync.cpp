@@ -0,0 +1,214 @@
+#include "Class/MqttSync.h"
+
+#include "Class/ChartWriter.h"
+#include "Class/MqttLimiter.h"
+#include "Global.h"
+#include "MqttClient.h"
+#include "items/vLogging.h"
+#include "items/vSensorNode.h"
+
+MqttSync mqttSync;
+
+void MqttSync::start() {
+    if (active()) {
+        _restarted++;
+    }
+    _started++;
+    _grafmax = jsonReadInt(configSetupJson, "grafmax");  //конфиг разбирается один раз на всю отправку
+    next(SYNC_WIDGETS);
+}
+
+void MqttSync::next(MqttSyncStage_t stage) {
+    _stage = stage;
+    _index = 0;
+    _cursor = 0;
+    _chunk = 0;
+    _lastTime = 0;
+}
+
+void MqttSync::loop() {
+    if (!active() || !mqtt.connected()) {
+        return;
+    }
+    unsigned long start = millis();
+    size_t bytes = 0;
+    for (uint8_t i = 0; i < MQTT_SYNC_MESSAGES && active(); i++) {
+        //ждет токенов сама, чтобы виджеты и куски графиков не откладывались и не схлопывались
+        MqttClass_t cls = stageClass();
+        if (!mqttLimiter.ready(cls)) {
+            break;
+        }
+        uint32_t sent = _sent;
+        mqttLimiter.bypass(true);
+        bool done = step(bytes);
+        mqttLimiter.bypass(false);
+        if (_sent != sent) {
+            mqttLimiter.charge(cls);
+        }
+        if (!done || bytes >= MQTT_SYNC_BYTES || millis() - start >= MQTT_SYNC_BUDGET_MS) {
+            break;
+        }
+    }
+}
+
+#ifdef EnableLogging
+//номер первой точки новее time: кольцо теряет точки только с начала, поэтому она не дальше hint
+static size_t firstAfter(LogFile& log, uint32_t time, size_t hint) {
+    size_t lo = 0;
+    size_t hi = hint < log.count() ? hint : log.count();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        uint32_t midTime = 0;
+        log.forEach([&midTime](const RingLogRecord& rec) {
+            midTime = rec.time;
+        }, mid, 1);
+        if (midTime <= time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+#endif
+
+MqttClass_t MqttSync::stageClass() const {
+    switch (_stage) {
+        case SYNC_WIDGETS:
+            return MC_CONFIG;
+        case SYNC_LOGS:
+            return MC_CHART;
+    }
+    return MC_STATUS;
+}
+
+bool MqttSync::step(size_t& bytes) {
+    switch (_stage) {
+        case SYNC_WIDGETS: {
+            String line;
+#ifdef LAYOUT_IN_RAM
+            while (_cursor < all_widgets.length() && !line.length()) {
+                int psn = all_widgets.indexOf("\r\n", _cursor);
+                if (psn < 0) {
+                    psn = all_widgets.length();
+                }
+                line = all_widgets.substring(_cursor, psn);
+                _cursor = psn + 2;
+            }
+#else
+            auto file = seekFile("layout.txt", _cursor);
+            if (file) {
+                if (file.available()) {
+                    line = file.readStringUntil('\n');
+                    _cursor = file.position();
+                }
+                file.close();
+            } else if (!_cursor) {
+                SerialPrint("[E]", "MQTT", "no file layout.txt");
+            }
+#endif
+            if (!line.length()) {
+                next(SYNC_LIVE);
+                return true;
+            }
+            publishData("config", line);
+            _sent++;
+            bytes += line.length();
+            return true;
+        }
+
+        case SYNC_LIVE:
+        case SYNC_STORE: {
+            const ValueTable& values = _stage == SYNC_LIVE ? liveValues : storeValues;
+            while (_index < values.size()) {
+                const String& topic = values.key(_index);
+                String state = values.getStr(_index);
+                _index++;
+                if (state != "" && topic != "timenow") {
+                    publishStatus(topic, state);
+                    _sent++;
+                    bytes += state.length();
+                    return true;
+                }
+            }
+            next(_stage == SYNC_LIVE ? SYNC_STORE : SYNC_TIMES);
+            return true;
+        }
+
+        case SYNC_TIMES: {
+#ifdef GATE_MODE
+            if (mySensorNode != nullptr && _index < mySensorNode->size()) {
+                mySensorNode->at(_index++).publish();
+                _sent++;
+                bytes++;
+                return true;
+            }
+#endif
+            next(SYNC_LOGS);
+            return true;
+        }
+
+        case SYNC_LOGS: {
+#ifdef EnableLogging
+            //лог отдается пачками по MQTT_SYNC_LOG_POINTS точек, пустой лог - одним пустым сообщением
+            //между проходами в лог дописываются точки и старые вытесняются, поэтому продолжение
+            //ищется по времени последней отправленной точки, а не по номеру
+            if (myLogging != nullptr && _index < myLogging->size()) {
+                const String& topic = myLogging->key(_index);
+                LogFile& log = myLogging->at(_index).logFile();
+                size_t from = _cursor ? firstAfter(log, _lastTime, _cursor) : 0;
+                size_t points = 0;
+                uint32_t lastTime = _lastTime;
+                size_t chunk = 0;
+                size_t written = 0;
+                bool ok = true;
+                ChartWriter writer(_grafmax, [this, &topic, &written, &chunk, &ok](const char* data, size_t length) {
+                    if (chunk++ < _chunk || !ok) {
+                        return;  //отправлен в прошлый раз или пачка уже уперлась
+                    }
+                    ok = publishChartChunk(topic, data, length);
+                    if (ok) {
+                        _chunk++;
+                        written += length;
+                    }
+                });
+                log.forEach([&writer, &points, &lastTime](const RingLogRecord& rec) {
+                    writer.add(rec.time, rec.value);
+                    lastTime = rec.time;
+                    points++;
+                }, from, MQTT_SYNC_LOG_POINTS);
+                if (points || !_cursor) {
+                    writer.finish();
+                }
+                bytes += written;
+                if (written) {
+                    _sent++;
+                }
+                if (!ok) {
+                    return false;
+                }
+                _chunk = 0;
+                _cursor = from + points;
+                _lastTime = lastTime;
+                if (points < MQTT_SYNC_LOG_POINTS) {
+                    _index++;
+                    _cursor = 0;
+                    _lastTime = 0;
+                }
+                return true;
+            }
+#endif
+            next(SYNC_IDLE);
+            SerialPrint("I", "MQTT", "Full update done");
+            return true;
+        }
+    }
+    return true;
+}
+
+void MqttSync::statsToJson(JsonObject& root) const {
+    root["syncStage"] = _stage;
+    root["syncStarted"] = _started;
+    root["syncRestarted"] = _restarted;
+    root["syncSent"] = _sent;
+}
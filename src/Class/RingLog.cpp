@@ -0,0 +1,194 @@
+#include "Class/RingLog.h"
+
+#include "Utils/FileUtils.h"
+#include "Utils/SerialPrint.h"
+
+RingLog::RingLog(const String& path, size_t capacity, uint16_t recordSize) {
+    _path = path;
+    if (capacity > RING_LOG_MAX_CAPACITY) {
+        SerialPrint("E", "RingLog", _path + " points " + String((unsigned long)capacity) + " > " + String(RING_LOG_MAX_CAPACITY));
+        capacity = RING_LOG_MAX_CAPACITY;
+    }
+    _hdr.magic = RING_LOG_MAGIC;
+    _hdr.capacity = capacity ? capacity : 1;
+    _hdr.recordSize = recordSize;
+    _hdr.head = 0;
+    _hdr.count = 0;
+    uint16_t wanted = _hdr.capacity;
+    if (!open()) {
+        create(wanted);
+    } else if (_hdr.capacity != wanted) {
+        resize(wanted);
+    }
+}
+
+bool RingLog::open() {
+    File file = FileFS.open(_path, FILE_READ);
+    if (!file) {
+        return false;
+    }
+    RingLogHeader hdr;
+    bool ok = file.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              hdr.magic == RING_LOG_MAGIC &&
+              hdr.recordSize == _hdr.recordSize &&
+              hdr.capacity && hdr.head < hdr.capacity && hdr.count <= hdr.capacity;
+    file.close();
+    if (ok) {
+        _hdr = hdr;
+    }
+    return ok;
+}
+
+bool RingLog::create(uint16_t capacity) {
+    _hdr.capacity = capacity;
+    _hdr.head = 0;
+    _hdr.count = 0;
+    File file = FileFS.open(_path, FILE_WRITE);
+    if (!file) {
+        SerialPrint("E", "RingLog", "create " + _path);
+        return false;
+    }
+    file.write((const uint8_t*)&_hdr, sizeof(_hdr));
+    file.close();
+    return true;
+}
+
+//при смене числа записей переносим последние в новый файл
+bool RingLog::resize(uint16_t capacity) {
+    String tmpPath = RING_LOG_TMP_FILE;
+    FileFS.remove(tmpPath);
+    RingLog tmp(tmpPath, capacity, _hdr.recordSize);
+    forEachRaw([&tmp](const uint8_t* rec) {
+        tmp.appendRaw(rec);
+    });
+    FileFS.remove(_path);
+    if (!FileFS.rename(tmpPath, _path)) {
+        SerialPrint("E", "RingLog", "rename " + tmpPath);
+        return false;
+    }
+    _hdr = tmp._hdr;
+    return true;
+}
+
+bool RingLog::writeRecord(File& file, const void* rec) {
+    file.seek(recordOffset(_hdr.head), SeekSet);
+    if (file.write((const uint8_t*)rec, _hdr.recordSize) != _hdr.recordSize) {
+        return false;
+    }
+    _hdr.head = (_hdr.head + 1) % _hdr.capacity;
+    if (_hdr.count < _hdr.capacity) {
+        _hdr.count++;
+    }
+    return true;
+}
+
+bool RingLog::appendRaw(const void* rec) {
+    File file = FileFS.open(_path, "r+");
+    if (!file) {
+        //файл удалили (очистка логов) - начинаем заново
+        if (!create(_hdr.capacity)) {
+            return false;
+        }
+        file = FileFS.open(_path, "r+");
+        if (!file) {
+            return false;
+        }
+    }
+    //на заполненном кольце точка ложится на самую старую: сначала на флеш уходит заголовок уже без нее,
+    //иначе при обрыве питания посреди записи недописанная ячейка осталась бы первой точкой
+    if (_hdr.count == _hdr.capacity) {
+        _hdr.count--;
+        file.seek(0, SeekSet);
+        file.write((const uint8_t*)&_hdr, sizeof(_hdr));
+        file.flush();
+    }
+    bool ok = writeRecord(file, rec);
+    //заголовок пишется после точки: при обрыве питания между ними теряется только эта точка
+    file.seek(0, SeekSet);
+    file.write((const uint8_t*)&_hdr, sizeof(_hdr));
+    file.close();
+    return ok;
+}
+
+void RingLog::forEachRaw(RingLogRawHandler_t handler, size_t start, size_t limit) {
+    if (start >= _hdr.count || _hdr.recordSize > RING_LOG_MAX_RECORD) {
+        return;
+    }
+    File file = FileFS.open(_path, FILE_READ);
+    if (!file) {
+        return;
+    }
+    size_t count = _hdr.count - start;
+    if (count > limit) {
+        count = limit;
+    }
+    uint8_t rec[RING_LOG_MAX_RECORD];
+    uint32_t idx = (oldestIndex() + start) % _hdr.capacity;
+    file.seek(recordOffset(idx), SeekSet);
+    for (size_t i = 0; i < count; i++) {
+        if (idx == _hdr.capacity) {
+            idx = 0;
+            file.seek(recordOffset(0), SeekSet);
+        }
+        if (file.read(rec, _hdr.recordSize) != _hdr.recordSize) {
+            break;
+        }
+        handler(rec);
+        idx++;
+    }
+    file.close();
+}
+
+void RingLog::forEach(RingLogHandler_t handler, size_t start, size_t limit) {
+    forEachRaw([&handler](const uint8_t* raw) {
+        RingLogRecord rec;
+        memcpy(&rec, raw, sizeof(rec));
+        handler(rec);
+    }, start, limit);
+}
+
+uint32_t RingLog::oldestTime() {
+    if (!_hdr.count) {
+        return 0;
+    }
+    File file = FileFS.open(_path, FILE_READ);
+    if (!file) {
+        return 0;
+    }
+    uint32_t time = 0;
+    file.seek(recordOffset(oldestIndex()), SeekSet);
+    file.read((uint8_t*)&time, sizeof(time));
+    file.close();
+    return time;
+}
+
+//перенос старого текстового лога "время значение" построчно
+bool RingLog::importText(const String& filename) {
+    File src = FileFS.open(filename, FILE_READ);
+    if (!src) {
+        return false;
+    }
+    File file = FileFS.open(_path, "r+");
+    if (!file) {
+        src.close();
+        return false;
+    }
+    size_t lines = 0;
+    while (src.available()) {
+        String line = src.readStringUntil('\n');
+        int space = line.indexOf(' ');
+        if (space <= 0) {
+            continue;
+        }
+        RingLogRecord rec = {(uint32_t)line.substring(0, space).toInt(), line.substring(space + 1).toFloat()};
+        writeRecord(file, &rec);
+        lines++;
+    }
+    file.seek(0, SeekSet);
+    file.write((const uint8_t*)&_hdr, sizeof(_hdr));
+    file.close();
+    src.close();
+    removeFile(filename);
+    SerialPrint("I", "RingLog", filename + " -> " + _path + ", points: " + String(lines));
+    return true;
+}
@@ -0,0 +1,62 @@
+#include "Class/Rollup.h"
+
+RollupTier::RollupTier(const String& path, size_t capacity, uint32_t period) : _ring(path, capacity, sizeof(RollupRecord)) {
+    _period = period ? period : 1;
+    _bucket.count = 0;
+    _sum = 0;
+}
+
+void RollupTier::add(uint32_t time, float value) {
+    uint32_t start = time - time % _period;
+    //точки из прошлого (перевели часы) досчитываются в текущий интервал
+    if (_bucket.count && start > _bucket.time) {
+        _bucket.avg = _sum / _bucket.count;
+        _ring.appendRaw(&_bucket);
+        _bucket.count = 0;
+    }
+    if (!_bucket.count) {
+        _bucket.time = start;
+        _bucket.min = value;
+        _bucket.max = value;
+        _sum = 0;
+    }
+    if (value < _bucket.min) {
+        _bucket.min = value;
+    }
+    if (value > _bucket.max) {
+        _bucket.max = value;
+    }
+    _sum += value;
+    _bucket.count++;
+}
+
+void RollupTier::forEach(RollupHandler_t handler) {
+    _ring.forEachRaw([&handler](const uint8_t* raw) {
+        RollupRecord rec;
+        memcpy(&rec, raw, sizeof(rec));
+        handler(rec);
+    });
+    if (_bucket.count) {
+        RollupRecord rec = _bucket;
+        rec.avg = _sum / rec.count;
+        handler(rec);
+    }
+}
+
+uint32_t RollupTier::oldestTime() {
+    if (_ring.count()) {
+        return _ring.oldestTime();
+    }
+    return _bucket.count ? _bucket.time : 0;
+}
+
+uint32_t RollupTier::resumeTime() {
+    if (!_ring.count()) {
+        return 0;
+    }
+    uint32_t time = 0;
+    _ring.forEachRaw([&time](const uint8_t* raw) {
+        memcpy(&time, raw, sizeof(time));
+    }, _ring.count() - 1, 1);
+    return time + _period;
+}
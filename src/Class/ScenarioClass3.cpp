@@ -1,17 +1,218 @@
 #include "Class/ScenarioClass3.h"
 
+#include "BufferExecute.h"
+#include "Class/EventCoalescer.h"
 #include "MqttClient.h"
 #include "RemoteOrdersUdp.h"
 Scenario* myScenario;
 
-void eventGen2(String eventName, String eventValue) {
-    if (!jsonReadBool(configSetupJson, "scen")) {
+//сценарий разбирается один раз при загрузке, а не при каждом проходе loop
+void Scenario::load(const String& text) {
+    _rules.clear();
+    _rulesCount = 0;
+    //номера ключей старого сценария больше не нужны, таблица собирается заново
+    eventCoalescer.clear();
+    keyTable.clear();
+
+    String condition;
+    String commands;
+    bool inBlock = false;
+
+    int psn = 0;
+    int len = text.length();
+    while (psn < len) {
+        int next = text.indexOf('\n', psn);
+        if (next == -1) {
+            next = len;
+        }
+        String line = text.substring(psn, next);
+        psn = next + 1;
+
+        line.replace("\r", "");
+        line.trim();
+        if (!line.length()) {
+            continue;
+        }
+
+        if (!inBlock) {
+            condition = line;
+            commands = "";
+            inBlock = true;
+        } else if (line == "end") {
+            addRule(condition, commands);
+            inBlock = false;
+        } else {
+            commands += line + "\n";
+        }
+    }
+    if (inBlock && commands.length()) {
+        addRule(condition, commands);
+    }
+
+    size_t keys = 0;
+    for (size_t i = 0; i < _rules.size(); i++) {
+        if (_rules[i].size()) {
+            keys++;
+        }
+    }
+    SerialPrint("I", "Scenario", "loaded " + String(_rulesCount) + " rules, " + String(keys) + " keys");
+}
+
+bool Scenario::addRule(const String& condition, const String& commands) {
+    String setEventKey = selectFromMarkerToMarker(condition, " ", 0);
+    String setEventSign = selectFromMarkerToMarker(condition, " ", 1);
+    String setEventValue = selectFromMarkerToMarker(condition, " ", 2);
+
+    ScenarioRule rule;
+    rule.sign = SS_UNKNOWN;
+    if (setEventSign == "=") {
+        rule.sign = SS_EQUAL;
+    } else if (setEventSign == "!=") {
+        rule.sign = SS_NOT_EQUAL;
+    } else if (setEventSign == "<") {
+        rule.sign = SS_LESS;
+    } else if (setEventSign == ">") {
+        rule.sign = SS_MORE;
+    } else if (setEventSign == "<=") {
+        rule.sign = SS_LESS_EQUAL;
+    } else if (setEventSign == ">=") {
+        rule.sign = SS_MORE_EQUAL;
+    }
+
+    if (setEventKey == "not found" || rule.sign == SS_UNKNOWN) {
+        SerialPrint("E", "Scenario", "wrong condition: " + condition);
+        return false;
+    }
+
+    rule.isRef = !isDigitDotCommaStr(setEventValue);
+    rule.hasHysteresis = false;
+    rule.hysteresis = 0;
+    if (rule.isRef && setEventValue.indexOf("+-") != -1) {
+        rule.hasHysteresis = true;
+        rule.hysteresis = selectToMarkerLast(setEventValue, "+-").toFloat();
+        setEventValue = selectToMarker(setEventValue, "+-");
+    }
+    rule.value = setEventValue;
+    rule.valueFloat = setEventValue.toFloat();
+    rule.condition = condition;
+    rule.commands = commands;
+
+    uint16_t keyId = keyTable.intern(setEventKey);
+    if (keyId == KEY_UNKNOWN) {
+        SerialPrint("E", "Scenario", "rule skipped: " + condition);
+        return false;
+    }
+    if (_rules.size() <= keyId) {
+        _rules.resize(keyId + 1);
+    }
+    _rules[keyId].push_back(rule);
+    _rulesCount++;
+    return true;
+}
+
+bool Scenario::isTriggered(const ScenarioRule& rule, const String& incommingEventValue) {
+    String setEventValue = rule.value;
+    float setEventValueFloat = rule.valueFloat;
+
+    if (rule.isRef) {
+        setEventValue = getValue(setEventValue);
+        setEventValueFloat = setEventValue.toFloat();
+        if (rule.hasHysteresis) {
+            if (rule.sign == SS_MORE) {
+                setEventValueFloat += rule.hysteresis;
+            } else if (rule.sign == SS_LESS) {
+                setEventValueFloat -= rule.hysteresis;
+            }
+        }
+    }
+
+    switch (rule.sign) {
+        case SS_EQUAL:
+            return incommingEventValue == setEventValue;
+        case SS_NOT_EQUAL:
+            return incommingEventValue != setEventValue;
+        case SS_LESS:
+            return incommingEventValue.toFloat() < setEventValueFloat;
+        case SS_MORE:
+            return incommingEventValue.toFloat() > setEventValueFloat;
+        case SS_LESS_EQUAL:
+            return incommingEventValue.toFloat() <= setEventValueFloat;
+        case SS_MORE_EQUAL:
+            return incommingEventValue.toFloat() >= setEventValueFloat;
+        default:
+            return false;
+    }
+}
+
+void Scenario::loop() {
+    if (!settings.scen) {
+        return;
+    }
+    unsigned long start = micros();
+    //разбираем события пока не выйдет время отведенное на проход, но минимум одно
+    //очередь последних значений и общая очередь разбираются поочередно
+    QueueRecord rec;
+    bool more = true;
+    while (more) {
+        more = false;
+        if (eventCoalescer.pop(rec)) {
+            processEvent(rec);
+            more = true;
+        }
+        if (eventQueue.pop(rec)) {
+            processEvent(rec);
+            more = true;
+        }
+        if (micros() - start >= settings.loopBudgetMu) {
+            break;
+        }
+    }
+}
+
+void Scenario::processEvent(const QueueRecord& rec) {
+    uint16_t keyId = rec.keyId;
+    if (keyId == KEY_UNKNOWN) {
+        //ключ мог попасть в таблицу уже после постановки события в очередь
+        keyId = keyTable.find(rec.key);
+    }
+    if (keyId >= _rules.size()) {
         return;
     }
-    String event = eventName + " " + eventValue + ",";
-    eventBuf += event;
 
-    if (jsonReadBool(configSetupJson, "MqttOut")) {
+    const ScenarioRules& bucket = _rules[keyId];
+    if (!bucket.size()) {
+        return;
+    }
+    const String& incommingEventValue = rec.value;
+
+    for (size_t i = 0; i < bucket.size(); i++) {
+        const ScenarioRule& rule = bucket.at(i);
+        if (isTriggered(rule, incommingEventValue)) {
+            String commands = rule.commands;
+            SerialPrint("I", "Scenario", rule.condition + " \n" + commands);
+            spaceCmdExecute(commands);
+        }
+    }
+}
+
+//coalesce - значение датчика: при evCoalesce новое заменяет еще не разобранное,
+//кнопки, вводы, pwm и время идут в общую очередь все до одного
+void eventGen2(String eventName, String eventValue, bool coalesce) {
+    if (!settings.scen) {
+        return;
+    }
+    //номера есть только у ключей правил, события без правил не занимают место в keyTable
+    uint16_t keyId = KEY_UNKNOWN;
+    if (coalesce && settings.evCoalesce) {
+        keyId = keyTable.find(eventName);
+    }
+    if (keyId != KEY_UNKNOWN) {
+        eventCoalescer.add(keyId, eventValue);
+    } else {
+        eventQueue.push(eventName, eventValue, ES_LOCAL);
+    }
+
+    if (settings.mqttOut) {
         if (eventName != "timenow") {
             publishEvent(eventName, eventValue);
         }
@@ -21,7 +222,7 @@ void eventGen2(String eventName, String eventValue) {
 void streamEventUDP(String event) {
 #ifdef UDP_ENABLED
 
-    if (!jsonReadBool(configSetupJson, "snaUdp")) {
+    if (!settings.snaUdp) {
         return;
     }
 
@@ -30,4 +231,4 @@ void streamEventUDP(String event) {
         asyncUdp.broadcastTo(event.c_str(), 4210);
     }
 #endif
-}
\ No newline at end of file
+}
@@ -0,0 +1,105 @@
+#include "Class/Settings.h"
+
+#include <ArduinoJson.h>
+
+#include "Global.h"
+
+Settings settings;
+
+static const struct {
+    const char* name;
+    bool Settings::*field;
+} settingsFlags[] = {
+    {"scen", &Settings::scen},
+    {"MqttIn", &Settings::mqttIn},
+    {"MqttOut", &Settings::mqttOut},
+    {"snaUdp", &Settings::snaUdp},
+    {"uart", &Settings::uart},
+    {"uartEvents", &Settings::uartEvents},
+    {"telegonof", &Settings::telegonof},
+    {"teleginput", &Settings::teleginput},
+    {"autos", &Settings::autos},
+    {"blink", &Settings::blink},
+    {"gateAuto", &Settings::gateAuto},
+    {"evCoalesce", &Settings::evCoalesce},
+};
+
+static const char* mqttRateKeys[MC_COUNT] = {"mqttRateStatus", "mqttRateEvent", "mqttRateChart", "mqttRateConfig", "mqttRateDevice"};
+
+int Settings::flag(const String& name) {
+    for (size_t i = 0; i < sizeof(settingsFlags) / sizeof(settingsFlags[0]); i++) {
+        if (name == settingsFlags[i].name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void Settings::load(const String& json) {
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.parseObject(json);
+    for (size_t i = 0; i < sizeof(settingsFlags) / sizeof(settingsFlags[0]); i++) {
+        this->*settingsFlags[i].field = root[settingsFlags[i].name].as<bool>();
+    }
+    long budget = root["loopBudget"].as<long>();
+    if (budget > 0) {
+        loopBudgetMu = budget;
+    }
+    long quiet = root["storeQuiet"].as<long>();
+    if (quiet > 0) {
+        storeQuietMs = quiet;
+    }
+    long maxDelay = root["storeMaxDelay"].as<long>();
+    if (maxDelay > 0) {
+        storeMaxDelayMs = maxDelay;
+    }
+    for (uint8_t i = 0; i < MC_COUNT; i++) {
+        long rate = root[mqttRateKeys[i]].as<long>();
+        if (rate > MQTT_RATE_MAX) {
+            SerialPrint("E", "Settings", String(mqttRateKeys[i]) + " > " + String(MQTT_RATE_MAX));
+            rate = MQTT_RATE_MAX;
+        }
+        if (rate > 0) {
+            mqttRate[i] = rate;
+        }
+    }
+}
+
+void Settings::setBool(const String& name, bool value) {
+    jsonWriteBool(configSetupJson, name, value);
+    int i = flag(name);
+    if (i < 0 || this->*settingsFlags[i].field == value) {
+        return;
+    }
+    this->*settingsFlags[i].field = value;
+    changed(name);
+}
+
+void Settings::changed(const String& name) {
+    int i = flag(name);
+    if (i < 0) {
+        return;
+    }
+#ifdef ESP8266
+    _changed |= 1UL << i;  //на ESP8266 веб и loop не выполняются одновременно, атомарных операций нет
+#else
+    __atomic_fetch_or(&_changed, 1UL << i, __ATOMIC_RELAXED);
+#endif
+}
+
+void Settings::loop() {
+#ifdef ESP8266
+    uint32_t changed = _changed;
+    _changed = 0;
+#else
+    uint32_t changed = __atomic_exchange_n(&_changed, 0, __ATOMIC_RELAXED);
+#endif
+    for (size_t i = 0; changed && i < sizeof(settingsFlags) / sizeof(settingsFlags[0]); i++) {
+        if (changed & (1UL << i)) {
+            String name = settingsFlags[i].name;
+            for (auto& handler : _handlers) {
+                handler(name);
+            }
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include "Class/TopicTrie.h"
+
+TopicTrie::TopicTrie() {
+    clear();
+}
+
+void TopicTrie::clear() {
+    _nodes.clear();
+    _nodes.push_back(Node{String(), -1, {}});
+    for (auto& route : _routes) {
+        route.handler = nullptr;
+    }
+}
+
+uint16_t TopicTrie::child(uint16_t node, const char* segment, size_t len) {
+    for (uint16_t idx : _nodes[node].children) {
+        const String& str = _nodes[idx].segment;
+        if (str.length() == len && !memcmp(str.c_str(), segment, len)) {
+            return idx;
+        }
+    }
+    TopicSegment view = {segment, len};
+    _nodes.push_back(Node{view.toString(), -1, {}});
+    uint16_t idx = _nodes.size() - 1;
+    _nodes[node].children.push_back(idx);
+    return idx;
+}
+
+void TopicTrie::add(const String& name, const String& filter, TopicHandler_t handler) {
+    int16_t route = -1;
+    for (size_t i = 0; i < _routes.size(); i++) {
+        if (_routes[i].name == name) {
+            route = i;
+            _routes[i].handler = handler;
+        }
+    }
+    if (route < 0) {
+        _routes.push_back(Route{name, handler, 0});
+        route = _routes.size() - 1;
+    }
+    uint16_t node = 0;
+    const char* psn = filter.c_str();
+    while (true) {
+        const char* slash = strchr(psn, '/');
+        size_t len = slash ? slash - psn : strlen(psn);
+        node = child(node, psn, len);
+        if (!slash) {
+            break;
+        }
+        psn = slash + 1;
+    }
+    _nodes[node].route = route;
+}
+
+//сначала точное совпадение сегмента, потом '+', потом '#'
+int16_t TopicTrie::match(uint16_t node, const char* psn, TopicMatch& match) const {
+    const char* slash = strchr(psn, '/');
+    size_t len = slash ? slash - psn : strlen(psn);
+    for (uint8_t pass = 0; pass < 3; pass++) {
+        for (uint16_t idx : _nodes[node].children) {
+            const Node& next = _nodes[idx];
+            if (pass == 0 && !(next.segment.length() == len && !memcmp(next.segment.c_str(), psn, len))) {
+                continue;
+            }
+            if (pass == 1 && next.segment != "+") {
+                continue;
+            }
+            if (pass == 2) {
+                if (next.segment != "#" || next.route < 0 || match.count >= TOPIC_MAX_CAPTURES) {
+                    continue;
+                }
+                match.captures[match.count++] = TopicSegment{psn, strlen(psn)};
+                return next.route;
+            }
+            uint8_t count = match.count;
+            if (pass == 1) {
+                if (match.count >= TOPIC_MAX_CAPTURES) {
+                    continue;
+                }
+                match.captures[match.count++] = TopicSegment{psn, len};
+            }
+            int16_t route = slash ? this->match(idx, slash + 1, match) : next.route;
+            if (route >= 0) {
+                return route;
+            }
+            match.count = count;
+        }
+    }
+    return -1;
+}
+
+bool TopicTrie::dispatch(const char* topic, const uint8_t* payload, size_t length) {
+    TopicMatch found;
+    found.count = 0;
+    int16_t route = match(0, topic, found);
+    if (route < 0 || !_routes[route].handler) {
+        _unmatched++;
+        return false;
+    }
+    _routes[route].hits++;
+    _routes[route].handler(topic, found, payload, length);
+    return true;
+}
+
+void TopicTrie::statsToJson(JsonObject& root) const {
+    for (size_t i = 0; i < _routes.size(); i++) {
+        root["mqttRx" + _routes[i].name] = _routes[i].hits;
+    }
+    root["mqttUnmatched"] = _unmatched;
+}
@@ -0,0 +1,162 @@
+#include "Class/ValueTable.h"
+
+#include <ArduinoJson.h>
+
+ValueTable liveValues;
+ValueTable storeValues;
+
+ValueTable::Entry& ValueTable::entry(const String& key) {
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+        return _entries[it->second];
+    }
+    _index[key] = _entries.size();
+    _entries.push_back(Entry{key, VT_STRING, 0, 0, ""});
+    changed();
+    return _entries.back();
+}
+
+const ValueTable::Entry* ValueTable::find(const String& key) const {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        return nullptr;
+    }
+    return &_entries[it->second];
+}
+
+void ValueTable::changed() {
+    _jsonValid = false;
+    _dirty = true;
+}
+
+void ValueTable::setStr(const String& key, const String& value) {
+    Entry& e = entry(key);
+    if (e.type == VT_STRING && e.strValue == value) {
+        return;
+    }
+    e.type = VT_STRING;
+    e.strValue = value;
+    changed();
+}
+
+void ValueTable::setInt(const String& key, int value) {
+    Entry& e = entry(key);
+    if (e.type == VT_INT && e.intValue == value) {
+        return;
+    }
+    e.type = VT_INT;
+    e.intValue = value;
+    e.strValue = "";
+    changed();
+}
+
+void ValueTable::setFloat(const String& key, float value) {
+    Entry& e = entry(key);
+    if (e.type == VT_FLOAT && e.floatValue == value) {
+        return;
+    }
+    e.type = VT_FLOAT;
+    e.floatValue = value;
+    e.strValue = "";
+    changed();
+}
+
+bool ValueTable::has(const String& key) const {
+    return find(key) != nullptr;
+}
+
+String ValueTable::getStr(size_t i) const {
+    const Entry& e = _entries.at(i);
+    switch (e.type) {
+        case VT_INT:
+            return String(e.intValue);
+        case VT_FLOAT:
+            return String(e.floatValue);
+        default:
+            return e.strValue;
+    }
+}
+
+String ValueTable::getStr(const String& key) const {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        return "";
+    }
+    return getStr(it->second);
+}
+
+int ValueTable::getInt(const String& key) const {
+    const Entry* e = find(key);
+    if (!e) {
+        return 0;
+    }
+    switch (e->type) {
+        case VT_INT:
+            return e->intValue;
+        case VT_FLOAT:
+            return (int)e->floatValue;
+        default:
+            return e->strValue.toInt();
+    }
+}
+
+float ValueTable::getFloat(const String& key) const {
+    const Entry* e = find(key);
+    if (!e) {
+        return 0;
+    }
+    switch (e->type) {
+        case VT_INT:
+            return e->intValue;
+        case VT_FLOAT:
+            return e->floatValue;
+        default:
+            return e->strValue.toFloat();
+    }
+}
+
+const String& ValueTable::toJson() {
+    if (_jsonValid) {
+        return _json;
+    }
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.createObject();
+    for (const Entry& e : _entries) {
+        switch (e.type) {
+            case VT_INT:
+                root[e.key] = e.intValue;
+                break;
+            case VT_FLOAT:
+                //как и раньше - строкой с двумя знаками
+                root[e.key] = String(e.floatValue);
+                break;
+            default:
+                root[e.key] = e.strValue;
+                break;
+        }
+    }
+    _json = "";
+    root.printTo(_json);
+    _jsonValid = true;
+    return _json;
+}
+
+void ValueTable::fromJson(const String& json) {
+    clear();
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.parseObject(json);
+    for (JsonPair& kv : root) {
+        if (kv.value.is<int>()) {
+            setInt(kv.key, kv.value.as<int>());
+        } else {
+            setStr(kv.key, kv.value.as<String>());
+        }
+    }
+    _dirty = false;
+}
+
+void ValueTable::clear() {
+    _entries.clear();
+    _index.clear();
+    changed();
+}
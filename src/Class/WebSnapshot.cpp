@@ -0,0 +1,63 @@
+#include "Class/WebSnapshot.h"
+
+#include "BufferExecute.h"
+#include "Class/ItemScheduler.h"
+#include "Class/ValueTable.h"
+
+WebSnapshot liveSnapshot([]() {
+    return getQueueStatsJson(liveValues.toJson());
+});
+WebSnapshot storeSnapshot([]() {
+    return storeValues.toJson();
+});
+WebSnapshot itemsSnapshot([]() {
+    return itemScheduler.getStatsJson();
+});
+
+uint32_t WebSnapshot::want() {
+    uint32_t builds = __atomic_load_n(&_builds, __ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&_fresh, __ATOMIC_ACQUIRE)) {
+        return builds;
+    }
+    __atomic_store_n(&_wanted, true, __ATOMIC_RELEASE);
+    return builds + 1;
+}
+
+bool WebSnapshot::get(uint32_t build, String& json) {
+    if (__atomic_load_n(&_builds, __ATOMIC_ACQUIRE) < build) {
+        return false;
+    }
+#ifndef ESP8266
+    std::lock_guard<std::mutex> lock(_mutex);
+#endif
+    json = _json;
+    return true;
+}
+
+//без запросов снимок не собирается, время loop на него не тратится
+void WebSnapshot::loop() {
+    unsigned long now = millis();
+    if (__atomic_load_n(&_fresh, __ATOMIC_RELAXED) && now - _at >= WEB_SNAPSHOT_MIN_MS) {
+        __atomic_store_n(&_fresh, false, __ATOMIC_RELEASE);
+    }
+    if (!__atomic_load_n(&_wanted, __ATOMIC_ACQUIRE) || __atomic_load_n(&_fresh, __ATOMIC_RELAXED)) {
+        return;
+    }
+    __atomic_store_n(&_wanted, false, __ATOMIC_RELAXED);
+    String json = _builder();  //собирается без блокировки, под ней только обмен строк
+    {
+#ifndef ESP8266
+        std::lock_guard<std::mutex> lock(_mutex);
+#endif
+        _json = json;
+    }
+    _at = now;
+    __atomic_store_n(&_builds, _builds + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&_fresh, true, __ATOMIC_RELEASE);
+}
+
+void webSnapshotsLoop() {
+    liveSnapshot.loop();
+    storeSnapshot.loop();
+    itemsSnapshot.loop();
+}
@@ -10,6 +10,7 @@ WiFiClient espClient;
 PubSubClient mqtt(espClient);
 StringCommand sCmd;
 AsyncWebServer server(80);
+LoopStats loopStats;
 
 
 /*
@@ -22,8 +23,6 @@ boolean savedFromWeb = false;
 
 // Json
 String configSetupJson = "{}";
-String configLiveJson = "{}";
-String configStoreJson = "{}";
 String configOptionJson = "{}";
 String telegramMsgJson = "{}";
 
@@ -31,38 +30,11 @@ String telegramMsgJson = "{}";
 String chipId = "";
 String prex = "";
 String all_widgets = "";
-String scenario = "";
 
 //orders and events
-String orderBuf = "";
-String eventBuf = "";
-String mysensorBuf = "";
 String itemsFile = "";
 String itemsLine = "";
 
-//key lists and numbers
-//=========================================
-String impuls_KeyList = "";
-int impuls_EnterCounter = -1;
-//=========================================
-String buttonOut_KeyList = "";
-int buttonOut_EnterCounter = -1;
-//=========================================
-String input_KeyList = "";
-int input_EnterCounter = -1;
-//=========================================
-String output_KeyList= "";
-int output_EnterCounter= -1;
-//=========================================
-String pwmOut_KeyList = "";
-int pwmOut_EnterCounter = -1;
-//=========================================
-String countDown_KeyList = "";
-int countDown_EnterCounter = -1;
-//=========================================
-String logging_KeyList = "";
-int logging_EnterCounter = -1;
-//=========================================
 
 
 String itemName;
@@ -1,6 +1,9 @@
 #include "Init.h"
 
 #include "BufferExecute.h"
+#include "Class/Deadband.h"
+#include "Class/ScenarioClass3.h"
+#include "Class/ItemScheduler.h"
 #include "Class/LineParsing.h"
 #include "Cmd.h"
 #include "Global.h"
@@ -28,22 +31,26 @@ void loadConfig() {
 
     String tmp = readFile("store.json", 4096);
     if (tmp != "failed") {
-        configStoreJson = tmp;
+        storeValues.fromJson(tmp);
     }
-    configStoreJson.replace("\r\n", "");
 
-    jsonWriteStr(configSetupJson, "warning1", "");
-    jsonWriteStr(configSetupJson, "warning2", "");
-    jsonWriteStr(configSetupJson, "warning3", "");
+    JsonBatch batch(configSetupJson);
+    batch.setStr("warning1", "")
+        .setStr("warning2", "")
+        .setStr("warning3", "");
 
-    jsonWriteStr(configSetupJson, "chipID", chipId);
-    jsonWriteInt(configSetupJson, "firmware_version", FIRMWARE_VERSION);
-    jsonWriteStr(configSetupJson, "firmware_name", FIRMWARE_NAME);
+    batch.setStr("chipID", chipId)
+        .setInt("firmware_version", FIRMWARE_VERSION)
+        .setStr("firmware_name", FIRMWARE_NAME);
+    batch.commit();
 
     prex = jsonReadStr(configSetupJson, "mqttPrefix") + "/" + chipId;
 
     serverIP = jsonReadStr(configSetupJson, "serverip");
 
+    settings.load(configSetupJson);
+    mqttConfigInit();
+
     SerialPrint("I", F("Conf"), F("Config Json Init"));
 }
 
@@ -65,6 +72,7 @@ void deviceInit() {
     myLineParsing.clearErrors();
 
     fileCmdExecute(String(DEVICE_CONFIG_FILE));
+    registerItems();
 
     int errors = myLineParsing.getPinErrors();
 
@@ -79,8 +87,8 @@ void deviceInit() {
 }
 
 void loadScenario() {
-    if (jsonReadStr(configSetupJson, "scen") == "1") {
-        scenario = readFile(String(DEVICE_SCENARIO_FILE), 2048);
+    if (settings.scen) {
+        myScenario->load(readFile(String(DEVICE_SCENARIO_FILE), 2048));
     }
 }
 
@@ -98,56 +106,45 @@ void handle_uptime() {
 }
 
 void clearVectors() {
+    itemScheduler.clear();
+    deadband.clear();
+
 #ifdef EnableLogging
     if (myLogging != nullptr) {
         myLogging->clear();
     }
-    logging_KeyList = "";
-    logging_EnterCounter = -1;
 #endif
 #ifdef EnableImpulsOut
     if (myImpulsOut != nullptr) {
         myImpulsOut->clear();
     }
-    impuls_KeyList = "";
-    impuls_EnterCounter = -1;
 #endif
 
 #ifdef EnableCountDown
     if (myCountDown != nullptr) {
         myCountDown->clear();
     }
-    countDown_KeyList = "";
-    countDown_EnterCounter = -1;
 #endif
 
 #ifdef EnableButtonOut
     if (myButtonOut != nullptr) {
         myButtonOut->clear();
     }
-    buttonOut_KeyList = "";
-    buttonOut_EnterCounter = -1;
 #endif
 #ifdef EnableInput
     if (myInput != nullptr) {
         myInput->clear();
     }
-    input_KeyList = "";
-    input_EnterCounter = -1;
 #endif
 #ifdef EnableOutput
     if (myOutput != nullptr) {
         myOutput->clear();
     }
-    output_KeyList = "";
-    output_EnterCounter = -1;
 #endif
 #ifdef EnablePwmOut
     if (myPwmOut != nullptr) {
         myPwmOut->clear();
     }
-    pwmOut_KeyList = "";
-    pwmOut_EnterCounter = -1;
 #endif
     //==================================
 #ifdef EnableSensorDallas
@@ -201,3 +198,54 @@ void clearVectors() {
     }
 #endif
 }
+
+template <typename T>
+static void registerVector(T* vector) {
+    if (vector != nullptr) {
+        itemScheduler.watch(vector);
+    }
+}
+
+//повторный вызов безопасен: уже наблюдаемые вектора пропускаются, а появившиеся после
+//первого элемента своего типа добавляются
+void registerItems() {
+#ifdef EnableCountDown
+    registerVector(myCountDown);
+#endif
+#ifdef EnableImpulsOut
+    registerVector(myImpulsOut);
+#endif
+#ifdef EnableLogging
+    registerVector(myLogging);
+#endif
+#ifdef EnableSensorDallas
+    registerVector(mySensorDallas2);
+#endif
+#ifdef EnableSensorUltrasonic
+    registerVector(mySensorUltrasonic);
+#endif
+#ifdef EnableSensorAnalog
+    registerVector(mySensorAnalog);
+#endif
+#ifdef EnableSensorDht
+    registerVector(mySensorDht);
+#endif
+#ifdef EnableSensorBme280
+    registerVector(mySensorBme280);
+#endif
+#ifdef EnableSensorBmp280
+    registerVector(mySensorBmp280);
+#endif
+#ifdef EnableSensorCcs811
+    registerVector(mySensorCcs811);
+#endif
+#ifdef EnableSensorPzem
+    registerVector(mySensorPzem);
+#endif
+#ifdef EnableSensorUptime
+    registerVector(mySensorUptime);
+#endif
+#ifdef EnableSensorNode
+    registerVector(mySensorNode);
+#endif
+}
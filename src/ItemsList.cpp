@@ -1,5 +1,6 @@
 #include "ItemsList.h"
 
+#include "Class/KvStore.h"
 #include "Class/NotAsync.h"
 #include "FileSystem.h"
 #include "Init.h"
@@ -164,16 +165,12 @@ void delAllItems() {
     removeFile(DEVICE_SCENARIO_FILE);
     addFile(DEVICE_SCENARIO_FILE, "//");
     removeFile("id.txt");
-    removeFile("order.txt");
-    removeFile("pins.txt");
+    kvStore.remove("order.txt");
+    kvStore.remove("pins.txt");
 }
 
 uint8_t getNewElementNumber(String file) {
-    uint8_t number = readFile(file, 100).toInt();
-    number++;
-    removeFile(file);
-    addFile(file, String(number));
-    return number;
+    return kvStore.increment(file);
 }
 
 uint8_t getFreePinAll() {
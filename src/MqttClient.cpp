@@ -1,7 +1,17 @@
 #include "MqttClient.h"
 
+#ifdef ESP8266
+#include <ESPAsyncTCP.h>
+#else
+#include <AsyncTCP.h>
+#endif
+
 #include "BufferExecute.h"
+#include "Class/MqttLimiter.h"
+#include "Class/MqttOutbox.h"
+#include "Class/MqttSync.h"
 #include "Class/NotAsync.h"
+#include "Class/TopicTrie.h"
 #include "Global.h"
 #include "Init.h"
 #include "items/vLogging.h"
@@ -14,6 +24,7 @@ MqttBroker activeBroker = MQTT_PRIMARY;
 
 String mqttPrefix;
 String mqttRootDevice;
+TopicTrie mqttRoutes;
 String mqttPass;
 String mqttServer;
 String mqttUser;
@@ -29,6 +40,76 @@ bool checkBrokerParams(MqttBroker broker) {
     return !jsonReadStr(configSetupJson, getParamName("Server", broker)).isEmpty();
 }
 
+static bool mqttConfigured = false;  //задан хоть один брокер: есть для кого копить сообщения в mqttOutbox
+
+//корень топиков и наличие брокера читаются еще до первого подключения,
+//чтобы сообщения, накопленные при старте, попали в outbox с правильными топиками
+void mqttConfigInit() {
+    mqttConfigured = checkBrokerParams(MQTT_PRIMARY) || checkBrokerParams(MQTT_RESERVE);
+    mqttPrefix = jsonReadStr(configSetupJson, "mqttPrefix");
+    mqttRootDevice = mqttPrefix + "/" + chipId;
+}
+
+//подключение к брокеру идет из mqttLoop по шагам, попытки - с растущей паузой и разбросом:
+//имя и TCP проверяются асинхронно (MS_PROBE), PubSubClient подключается только к ответившему брокеру
+enum MqttState_t { MS_WAIT,
+                   MS_PROBE,
+                   MS_SUBSCRIBE,
+                   MS_CONNECTED };
+
+enum MqttProbe_t { PROBE_WAIT,
+                   PROBE_OK,
+                   PROBE_FAIL };
+
+static uint8_t mqttState = MS_WAIT;
+static unsigned long mqttRetryAt = 0;
+static uint32_t mqttBackoff = MQTT_BACKOFF_MIN_MS;
+static bool mqttResolved = false;
+static IPAddress mqttServerIp;
+
+static AsyncClient mqttProbe;
+static unsigned long mqttProbeAt = 0;
+static uint8_t mqttProbeResult = PROBE_WAIT;  //пишут обработчики mqttProbe, на ESP32 - из задачи async_tcp
+static uint32_t mqttProbeIp = 0;
+
+static bool mqttProbeStart();
+
+static void mqttProbeInit() {
+    mqttProbe.onConnect(
+        [](void*, AsyncClient* client) {
+            __atomic_store_n(&mqttProbeIp, (uint32_t)client->remoteIP(), __ATOMIC_RELAXED);
+            __atomic_store_n(&mqttProbeResult, (uint8_t)PROBE_OK, __ATOMIC_RELEASE);
+            client->close();
+        },
+        nullptr);
+    //ошибка после успешного соединения (его закрытие) результат не меняет
+    mqttProbe.onError(
+        [](void*, AsyncClient*, int8_t) {
+            if (__atomic_load_n(&mqttProbeResult, __ATOMIC_ACQUIRE) == PROBE_WAIT) {
+                __atomic_store_n(&mqttProbeResult, (uint8_t)PROBE_FAIL, __ATOMIC_RELEASE);
+            }
+        },
+        nullptr);
+}
+
+static void mqttProbeStop() {
+    if (mqttState == MS_PROBE) {
+        mqttProbe.close(true);
+    }
+}
+
+static void mqttRetryLater() {
+    uint32_t jitter = random(mqttBackoff / 4 + 1);
+    uint32_t delayMs = mqttBackoff - mqttBackoff / 8 + jitter;  //+-12.5%
+    mqttRetryAt = millis() + delayMs;
+    mqttState = MS_WAIT;
+    if (mqttBackoff < MQTT_BACKOFF_MAX_MS) {
+        mqttBackoff = mqttBackoff * 2 < MQTT_BACKOFF_MAX_MS ? mqttBackoff * 2 : MQTT_BACKOFF_MAX_MS;
+    }
+    SerialPrint("E", "MQTT", "could't connect, retry in " + String(delayMs / 1000) + "s");
+    setLedStatus(LED_FAST);
+}
+
 void mqttInit() {
     myNotAsyncActions->add(
         do_MQTTPARAMSCHANGED, [&](void*) {
@@ -37,6 +118,14 @@ void mqttInit() {
         nullptr);
 
     mqtt.setCallback(mqttCallback);
+    mqttProbeInit();
+    //connect() ждет TCP и ответа брокера не дольше этих значений
+#ifdef ESP32
+    espClient.setTimeout(MQTT_CONNECT_TIMEOUT_MS / 1000);  //в ядре ESP32 - секунды
+#else
+    espClient.setTimeout(MQTT_CONNECT_TIMEOUT_MS);
+#endif
+    mqtt.setSocketTimeout(MQTT_CONNECT_TIMEOUT_MS / 1000 + 1);
 
     ts.add(
         WIFI_MQTT_CONNECTION_CHECK, MQTT_RECONNECT_INTERVAL,
@@ -58,18 +147,7 @@ void mqttInit() {
                         setLedStatus(LED_OFF);
                     }
                 } else {
-                    SerialPrint("E", "MQTT", "lost connection");
-                    if (reconnectionCounter++ > 5) {
-                        if (activeBroker == MQTT_PRIMARY) {
-                            if (checkBrokerParams(MQTT_RESERVE)) {
-                                activeBroker = MQTT_RESERVE;
-                            }
-                        } else {
-                            activeBroker = MQTT_PRIMARY;
-                        }
-                        reconnectionCounter = 0;
-                    }
-                    mqttConnect();
+                    SerialPrint("E", "MQTT", "no connection");
                 }
             } else {
                 SerialPrint("E", "WIFI", "Lost WiFi connection");
@@ -92,16 +170,57 @@ void mqttDisconnect() {
     mqtt.disconnect();
 }
 
+//новые параметры или другой брокер - подключиться сразу
 void mqttReconnect() {
     mqttDisconnect();
-    mqttConnect();
+    mqttProbeStop();
+    mqttState = MS_WAIT;
+    mqttRetryAt = millis();
+    mqttBackoff = MQTT_BACKOFF_MIN_MS;
+    mqttResolved = false;
+    mqttConfigInit();
 }
 
 void mqttLoop() {
-    if (!isNetworkActive() || !mqtt.connected()) {
+    if (!isNetworkActive()) {
+        return;
+    }
+    if (!mqtt.connected()) {
+        if (mqttState == MS_SUBSCRIBE || mqttState == MS_CONNECTED) {
+            SerialPrint("E", "MQTT", "lost connection");
+            mqttState = MS_WAIT;
+            mqttRetryAt = millis();
+        }
+        if (mqttState == MS_PROBE) {
+            uint8_t probe = __atomic_load_n(&mqttProbeResult, __ATOMIC_ACQUIRE);
+            if (probe == PROBE_WAIT && millis() - mqttProbeAt < MQTT_CONNECT_TIMEOUT_MS) {
+                return;
+            }
+            if (probe != PROBE_OK) {
+                mqttProbeStop();
+                mqttResolved = false;  //адрес брокера мог смениться
+                mqttRetryLater();
+                return;
+            }
+            if (!mqttConnect()) {
+                mqttRetryLater();
+            }
+            return;
+        }
+        if ((long)(millis() - mqttRetryAt) >= 0 && !mqttProbeStart()) {
+            mqttRetryLater();
+        }
+        return;
+    }
+    if (mqttState == MS_SUBSCRIBE) {
+        mqttSubscribe();
+        mqttState = MS_CONNECTED;
         return;
     }
     mqtt.loop();
+    mqttOutbox.loop();
+    mqttLimiter.loop();
+    mqttSync.loop();
 }
 
 void mqttSubscribe() {
@@ -110,11 +229,12 @@ void mqttSubscribe() {
     mqtt.subscribe((mqttRootDevice + "/+/control").c_str());
     mqtt.subscribe((mqttRootDevice + "/update").c_str());
 
-    if (jsonReadBool(configSetupJson, "MqttIn")) {
+    if (settings.mqttIn) {
         mqtt.subscribe((mqttPrefix + "/+/+/event").c_str());
         mqtt.subscribe((mqttPrefix + "/+/+/order").c_str());
         mqtt.subscribe((mqttPrefix + "/+/+/info").c_str());
     }
+    mqttRoutesInit();
 }
 
 bool readBrokerParams(MqttBroker broker) {
@@ -129,116 +249,297 @@ bool readBrokerParams(MqttBroker broker) {
     return true;
 }
 
-boolean mqttConnect() {
+//начало попытки: выбор брокера, разрешение имени и TCP соединение без ожидания,
+//результат mqttLoop забирает в MS_PROBE не позже MQTT_CONNECT_TIMEOUT_MS
+static bool mqttProbeStart() {
+    if (reconnectionCounter++ >= MQTT_BROKER_SWITCH) {
+        if (activeBroker == MQTT_PRIMARY) {
+            if (checkBrokerParams(MQTT_RESERVE)) {
+                activeBroker = MQTT_RESERVE;
+            }
+        } else {
+            activeBroker = MQTT_PRIMARY;
+        }
+        reconnectionCounter = 1;
+        mqttResolved = false;
+    }
     SerialPrint("I", "MQTT", String("use ") + (activeBroker == MQTT_PRIMARY ? "primary" : "reserve"));
     if (!checkBrokerParams(activeBroker)) {
         SerialPrint("E", "MQTT", "empty broker address");
         return false;
     }
-    readBrokerParams(activeBroker);
+    if (!mqttResolved) {
+        readBrokerParams(activeBroker);
+        mqttConfigInit();
+        SerialPrint("I", "MQTT", "broker " + mqttServer + ":" + String(mqttPort, DEC));
+        SerialPrint("I", "MQTT", "topic " + mqttRootDevice);
+    }
+    __atomic_store_n(&mqttProbeResult, (uint8_t)PROBE_WAIT, __ATOMIC_RELEASE);
+    bool started = mqttResolved ? mqttProbe.connect(mqttServerIp, mqttPort) : mqttProbe.connect(mqttServer.c_str(), mqttPort);
+    if (!started) {
+        return false;
+    }
     SerialPrint("I", "MQTT", "start connection");
-    mqttPrefix = jsonReadStr(configSetupJson, "mqttPrefix");
-    mqttRootDevice = mqttPrefix + "/" + chipId;
-    SerialPrint("I", "MQTT", "broker " + mqttServer + ":" + String(mqttPort, DEC));
-    SerialPrint("I", "MQTT", "topic " + mqttRootDevice);
     setLedStatus(LED_FAST);
-    mqtt.setServer(mqttServer.c_str(), mqttPort);
-    bool res = false;
-    if (!mqtt.connected()) {
-        if (mqtt.connect(chipId.c_str(), mqttUser.c_str(), mqttPass.c_str())) {
-            SerialPrint("I", "MQTT", "connected");
-            setLedStatus(LED_OFF);
-            mqttSubscribe();
-            res = true;
-        } else {
-            SerialPrint("E", "MQTT", "could't connect, retry in " + String(MQTT_RECONNECT_INTERVAL / 1000) + "s");
-            setLedStatus(LED_FAST);
-        }
-    }
-    return res;
+    mqttProbeAt = millis();
+    mqttState = MS_PROBE;
+    return true;
 }
 
-void mqttCallback(char* topic, uint8_t* payload, size_t length) {
-    String topicStr = String(topic);
-    //SerialPrint("I", "=>MQTT", topicStr);
-    String payloadStr;
-    payloadStr.reserve(length + 1);
-    for (size_t i = 0; i < length; i++) {
-        payloadStr += (char)payload[i];
+//брокер только что принял TCP: connect() PubSubClient не ждет сетевых таймаутов,
+//подписка - следующим шагом mqttLoop
+boolean mqttConnect() {
+    if (!mqttResolved) {
+        mqttServerIp = IPAddress(__atomic_load_n(&mqttProbeIp, __ATOMIC_RELAXED));
+        mqtt.setServer(mqttServerIp, mqttPort);
+        mqttResolved = true;
     }
+    if (!mqtt.connect(chipId.c_str(), mqttUser.c_str(), mqttPass.c_str())) {
+        return false;
+    }
+    SerialPrint("I", "MQTT", "connected");
+    setLedStatus(LED_OFF);
+    mqttState = MS_SUBSCRIBE;
+    mqttBackoff = MQTT_BACKOFF_MIN_MS;
+    reconnectionCounter = 0;
+    return true;
+}
+
+static String payloadToString(const uint8_t* payload, size_t length) {
+    TopicSegment view = {(const char*)payload, length};
+    return view.toString();
+}
+
+//маршруты строятся заново при каждой подписке: префикс мог смениться
+void mqttRoutesInit() {
+    mqttRoutes.clear();
+
+    mqttRoutes.add("Control", mqttRootDevice + "/+/control", [](const char* topic, const TopicMatch& match, const uint8_t* payload, size_t length) {
+        String key = match.captures[0].toString();
+        String value = payloadToString(payload, length);
+        loopCmdAdd(key + " " + value + ",", ES_MQTT);
+        SerialPrint("I", "=>MQTT", "Msg from iotmanager app: " + key + " " + value);
+    });
+
+    mqttRoutes.add("Event", mqttPrefix + "/+/+/event", [](const char* topic, const TopicMatch& match, const uint8_t* payload, size_t length) {
+        const TopicSegment& devId = match.captures[0];
+        const TopicSegment& key = match.captures[1];
+        if (!settings.mqttIn || devId.equals(chipId)) {
+            return;
+        }
+        SerialPrint("I", "=>MQTT", "Received event from other device: '" + devId.toString() + "' " + key.toString() + " " + payloadToString(payload, length));
+        eventQueue.push(key.ptr, key.len, (const char*)payload, length, ES_MQTT);
+    });
 
-    //SerialPrint("I", "=>MQTT", payloadStr);
+    mqttRoutes.add("Order", mqttPrefix + "/+/+/order", [](const char* topic, const TopicMatch& match, const uint8_t* payload, size_t length) {
+        const TopicSegment& key = match.captures[1];
+        if (!settings.mqttIn) {
+            return;
+        }
+        SerialPrint("I", "=>MQTT", "Received direct order " + key.toString() + " " + payloadToString(payload, length));
+        if (!orderQueue.push(key.ptr, key.len, (const char*)payload, length, ES_MQTT)) {
+            SerialPrint("E", "=>MQTT", "order queue full, lost: " + key.toString());
+        }
+    });
+
+    mqttRoutes.add("Info", mqttPrefix + "/+/+/info", [](const char* topic, const TopicMatch& match, const uint8_t* payload, size_t length) {
+        if (strstr(topic, "scen")) {
+            writeFile(String(DEVICE_SCENARIO_FILE), payloadToString(payload, length));
+            loadScenario();
+            SerialPrint("I", "=>MQTT", "Scenario received");
+        }
+    });
+}
 
-    if (payloadStr.startsWith("HELLO")) {
+void mqttCallback(char* topic, uint8_t* payload, size_t length) {
+    if (length >= 5 && !memcmp(payload, "HELLO", 5)) {
         SerialPrint("I", "MQTT", "Full update");
-        publishWidgets();
-        publishState();
-#ifdef GATE_MODE
-        publishTimes();
-#endif
-#ifdef EnableLogging
-        choose_log_date_and_send();
-#endif
+        mqttSync.start();  //отправка идет из mqttLoop по частям
+        return;
     }
+    mqttRoutes.dispatch(topic, payload, length);
+}
 
-    else if (topicStr.indexOf("control") != -1) {
-        String key = selectFromMarkerToMarker(topicStr, "/", 3);
+//топики и тела сообщений собираются в статических буферах, публикация не выделяет память
+static char topicBuf[MQTT_TOPIC_SIZE];
+static char payloadBuf[MQTT_PAYLOAD_SIZE];
 
-        String order;
-        order += key;
-        order += " ";
-        order += payloadStr;
-        order += ",";
+static const char* makeTopic(const String& root, const String& topic, const char* suffix) {
+    size_t len = snprintf(topicBuf, sizeof(topicBuf), "%s/%s%s", root.c_str(), topic.c_str(), suffix);
+    if (len >= sizeof(topicBuf)) {
+        SerialPrint("[E]", "MQTT", "topic too long: " + topic);
+        return nullptr;
+    }
+    return topicBuf;
+}
 
-        loopCmdAdd(order);
+/*
+* Тело {"key":"value"} пишется в mqtt через payloadBuf без сборки строки
+* Первый проход только считает длину для beginPublish, экранирование как в ArduinoJson
+*/
+class JsonPayload {
+   public:
+    explicit JsonPayload(bool send, String* out = nullptr) : _send(send), _out(out), _length(0), _fill(0) {}
+
+    void raw(const char* data, size_t len) {
+        _length += len;
+        if (!_send) {
+            return;
+        }
+        while (len) {
+            if (_fill == sizeof(payloadBuf)) {
+                flush();
+            }
+            size_t part = sizeof(payloadBuf) - _fill;
+            if (part > len) {
+                part = len;
+            }
+            memcpy(payloadBuf + _fill, data, part);
+            _fill += part;
+            data += part;
+            len -= part;
+        }
+    }
 
-        SerialPrint("I", "=>MQTT", "Msg from iotmanager app: " + key + " " + payloadStr);
+    void str(const char* value, size_t len) {
+        raw("\"", 1);
+        const char* psn = value;
+        const char* end = psn + len;
+        const char* plain = psn;
+        for (; psn < end; psn++) {
+            char esc = escape(*psn);
+            if (esc) {
+                raw(plain, psn - plain);
+                char pair[2] = {'\\', esc};
+                raw(pair, 2);
+                plain = psn + 1;
+            }
+        }
+        raw(plain, end - plain);
+        raw("\"", 1);
     }
 
-    else if (topicStr.indexOf("event") != -1) {
-        if (!jsonReadBool(configSetupJson, "MqttIn")) {
-            return;
+    void flush() {
+        if (_out) {
+            _out->reserve(_length);
+            for (size_t i = 0; i < _fill; i++) {
+                *_out += payloadBuf[i];
+            }
+        } else {
+            mqtt.write((const uint8_t*)payloadBuf, _fill);
         }
-        if (topicStr.indexOf(chipId) == -1) {
-            String devId = selectFromMarkerToMarker(topicStr, "/", 2);
-            String key = selectFromMarkerToMarker(topicStr, "/", 3);
-            SerialPrint("I", "=>MQTT", "Received event from other device: '" + devId + "' " + key + " " + payloadStr);
-            String event = key + " " + payloadStr + ",";
-            eventBuf += event;
+        _fill = 0;
+    }
+
+    size_t length() const {
+        return _length;
+    }
+
+   private:
+    static char escape(char c) {
+        switch (c) {
+            case '"':
+                return '"';
+            case '\\':
+                return '\\';
+            case '\b':
+                return 'b';
+            case '\f':
+                return 'f';
+            case '\n':
+                return 'n';
+            case '\r':
+                return 'r';
+            case '\t':
+                return 't';
         }
+        return 0;
     }
 
-    else if (topicStr.indexOf("order") != -1) {
-        if (!jsonReadBool(configSetupJson, "MqttIn")) {
-            return;
+    bool _send;
+    String* _out;  //собрать в строку вместо отправки
+    size_t _length;
+    size_t _fill;
+};
+
+static void jsonBody(JsonPayload& payload, const char* key, const String& value) {
+    payload.raw("{", 1);
+    payload.str(key, strlen(key));
+    payload.raw(":", 1);
+    payload.str(value.c_str(), value.length());
+    payload.raw("}", 1);
+}
+
+//без связи или пока не отправлено накопленное сообщение ждет в mqttOutbox
+//сверх лимита частоты - в mqttLimiter, а пока там ждет значение этого топика, новое его заменяет
+static boolean publishJson(const char* topic, const char* key, const String& value) {
+    if (!topic) {
+        return false;
+    }
+    bool throttled = mqttLimiter.pending(topic, key);
+    if (!throttled && mqtt.connected() && mqttOutbox.empty()) {
+        throttled = !mqttLimiter.take(MC_STATUS);
+        if (!throttled) {
+            JsonPayload measure(false);
+            jsonBody(measure, key, value);
+            if (mqtt.beginPublish(topic, measure.length(), false)) {
+                JsonPayload payload(true);
+                jsonBody(payload, key, value);
+                payload.flush();
+                if (mqtt.endPublish()) {
+                    return true;
+                }
+            }
         }
-        String devId = selectFromMarkerToMarker(topicStr, "/", 2);
-        String key = selectFromMarkerToMarker(topicStr, "/", 3);
-        SerialPrint("I", "=>MQTT", "Received direct order " + key + " " + payloadStr);
-        String order = key + " " + payloadStr + ",";
-        orderBuf += order;
     }
+    if (!throttled && !mqttConfigured) {
+        return false;  //брокер не настроен - копить некому
+    }
+    String body;
+    JsonPayload payload(true, &body);
+    jsonBody(payload, key, value);
+    payload.flush();
+    if (throttled) {
+        return mqttLimiter.defer(MC_STATUS, topic, body, false, key);
+    }
+    return mqttOutbox.add(topic, body, false, key);
+}
 
-    else if (topicStr.indexOf("info") != -1) {
-        if (topicStr.indexOf("scen") != -1) {
-            writeFile(String(DEVICE_SCENARIO_FILE), payloadStr);
-            loadScenario();
-            SerialPrint("I", "=>MQTT", "Scenario received");
+static boolean publishOrQueue(MqttClass_t cls, const char* topic, const String& data, bool retain) {
+    if (!topic) {
+        return false;
+    }
+    bool throttled = mqttLimiter.pending(topic, nullptr);
+    if (!throttled && mqtt.connected() && mqttOutbox.empty()) {
+        throttled = !mqttLimiter.take(cls);
+        if (!throttled && publish(topic, data.c_str(), data.length(), retain)) {
+            return true;
         }
     }
+    if (throttled) {
+        return mqttLimiter.defer(cls, topic, data, retain, nullptr);
+    }
+    if (!mqttConfigured) {
+        return false;
+    }
+    return mqttOutbox.add(topic, data, retain, nullptr);
 }
 
 boolean publish(const String& topic, const String& data) {
-    if (mqtt.beginPublish(topic.c_str(), data.length(), false)) {
-        mqtt.print(data);
+    return publish(topic.c_str(), data.c_str(), data.length(), false);
+}
+
+boolean publish(const char* topic, const char* data, size_t length, bool retain) {
+    if (topic && mqtt.beginPublish(topic, length, retain)) {
+        mqtt.write((const uint8_t*)data, length);
         return mqtt.endPublish();
     }
     return false;
 }
 
+//конфигурация не схлопывается: все виджеты идут в один топик, сверх лимита сообщение не отправляется
 boolean publishData(const String& topic, const String& data) {
-    String path = mqttRootDevice + "/" + topic;
-    if (!publish(path, data)) {
+    if (!mqttLimiter.take(MC_CONFIG) || !publish(makeTopic(mqttRootDevice, topic, ""), data.c_str(), data.length())) {
         SerialPrint("[E]", "MQTT", "on publish data");
         return false;
     }
@@ -246,8 +547,35 @@ boolean publishData(const String& topic, const String& data) {
 }
 
 boolean publishChart(const String& topic, const String& data) {
-    String path = mqttRootDevice + "/" + topic + "/status";
-    if (!publish(path, data)) {
+    return publishChart(topic, data.c_str(), data.length());
+}
+
+//точка графика сверх лимита откладывается, в логе на флеше она уже есть
+boolean publishChart(const String& topic, const char* data, size_t length) {
+    const char* chartTopic = makeTopic(mqttRootDevice, topic, "/status");
+    if (chartTopic && (mqttLimiter.pending(chartTopic, nullptr) || !mqttLimiter.take(MC_CHART))) {
+        String body;
+        body.reserve(length);
+        for (size_t i = 0; i < length; i++) {
+            body += data[i];
+        }
+        return mqttLimiter.defer(MC_CHART, chartTopic, body, false, nullptr);
+    }
+    if (!publish(chartTopic, data, length)) {
+        SerialPrint("[E]", "MQTT", "on publish chart");
+        return false;
+    }
+    return true;
+}
+
+//для полной отправки: кусок истории не откладывается и не схлопывается с другими,
+//false - по этому топику уже ждет отложенная точка или отправка не прошла, кусок надо повторить
+boolean publishChartChunk(const String& topic, const char* data, size_t length) {
+    const char* chartTopic = makeTopic(mqttRootDevice, topic, "/status");
+    if (!chartTopic || mqttLimiter.pending(chartTopic, nullptr)) {
+        return false;
+    }
+    if (!publish(chartTopic, data, length)) {
         SerialPrint("[E]", "MQTT", "on publish chart");
         return false;
     }
@@ -255,106 +583,27 @@ boolean publishChart(const String& topic, const String& data) {
 }
 
 boolean publishControl(String id, String topic, String state) {
-    String path = mqttPrefix + "/" + id + "/" + topic + "/control";
-    return mqtt.publish(path.c_str(), state.c_str(), false);
+    return publish(makeTopic(mqttPrefix + "/" + id, topic, "/control"), state.c_str(), state.length());
 }
 
 boolean publishChart_test(const String& topic, const String& data) {
-    String path = mqttRootDevice + "/" + topic + "/status";
-    return mqtt.publish(path.c_str(), data.c_str(), false);
+    return publish(makeTopic(mqttRootDevice, topic, "/status"), data.c_str(), data.length());
 }
 
 boolean publishStatus(const String& topic, const String& data) {
-    String path = mqttRootDevice + "/" + topic + "/status";
-    String json = "{}";
-    jsonWriteStr(json, "status", data);
-    return mqtt.publish(path.c_str(), json.c_str(), false);
+    return publishJson(makeTopic(mqttRootDevice, topic, "/status"), "status", data);
 }
 
 boolean publishAnyJsonKey(const String& topic, const String& key, const String& data) {
-    String path = mqttRootDevice + "/" + topic + "/status";
-    String json = "{}";
-    jsonWriteStr(json, key, data);
-    return mqtt.publish(path.c_str(), json.c_str(), false);
+    return publishJson(makeTopic(mqttRootDevice, topic, "/status"), key.c_str(), data);
 }
 
 boolean publishEvent(const String& topic, const String& data) {
-    String path = mqttRootDevice + "/" + topic + "/event";
-    return mqtt.publish(path.c_str(), data.c_str(), true);
+    return publishOrQueue(MC_EVENT, makeTopic(mqttRootDevice, topic, "/event"), data, true);
 }
 
 boolean publishInfo(const String& topic, const String& data) {
-    String path = mqttRootDevice + "/" + topic + "/info";
-    return mqtt.publish(path.c_str(), data.c_str(), false);
-}
-
-#ifdef LAYOUT_IN_RAM
-void publishWidgets() {
-    if (all_widgets != "") {
-        int counter = 0;
-        String line;
-        int psn_1 = 0;
-        int psn_2;
-        do {
-            psn_2 = all_widgets.indexOf("\r\n", psn_1);  //\r\n
-            line = all_widgets.substring(psn_1, psn_2);
-            line.replace("\n", "");
-            line.replace("\r\n", "");
-            //jsonWriteStr(line, "id", String(counter));
-            //jsonWriteStr(line, "pageId", String(counter));
-            counter++;
-            sendMQTT("config", line);
-            Serial.println("[V] " + line);
-            psn_1 = psn_2 + 1;
-        } while (psn_2 + 2 < all_widgets.length());
-        getMemoryLoad("I after send all widgets");
-    }
-}
-#endif
-
-#ifndef LAYOUT_IN_RAM
-void publishWidgets() {
-    auto file = seekFile("layout.txt");
-    if (!file) {
-        SerialPrint("[E]", "MQTT", "no file layout.txt");
-        return;
-    }
-    while (file.available()) {
-        String payload = file.readStringUntil('\n');
-        SerialPrint("I", "MQTT", "widgets: " + payload);
-        publishData("config", payload);
-    }
-    file.close();
-}
-#endif
-
-void publishState() {
-    // берет строку json и ключи превращает в топики а значения колючей в них посылает
-    String str;
-    if (configLiveJson != "{}") {
-        str += configLiveJson;
-    }
-    if (configStoreJson != "{}") {
-        str += "," + configStoreJson;
-    }
-    str.replace("{", "");
-    str.replace("}", "");
-    str.replace("\"", "");
-    str += ",";
-
-    while (str.length() != 0) {
-        String tmp = selectToMarker(str, ",");
-
-        String topic = selectToMarker(tmp, ":");
-        String state = deleteBeforeDelimiter(tmp, ":");
-
-        if (topic != "" && state != "") {
-            if (topic != "timenow") {
-                publishStatus(topic, state);
-            }
-        }
-        str = deleteBeforeDelimiter(str, ",");
-    }
+    return publish(makeTopic(mqttRootDevice, topic, "/info"), data.c_str(), data.length());
 }
 
 const String getStateStr() {
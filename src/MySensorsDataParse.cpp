@@ -1,5 +1,6 @@
 #include "Consts.h"
 #ifdef MYSENSORS
+#include "Class/EventQueue.h"
 #include "Class/NotAsync.h"
 #include "ItemsList.h"
 #include "MySensorsDataParse.h"
@@ -8,72 +9,79 @@
 //для того что бы выключить оригинальный лог нужно перейти в файл библиотеки MyGatewayTransportSerial.cpp
 //и заккоментировать строку 36 MY_SERIALDEVICE.print(protocolMyMessage2Serial(message));
 
-void loopMySensorsExecute() {
-    if (mysensorBuf.length()) {
-        String tmp = selectToMarker(mysensorBuf, ";");
+static bool presentBeenStarted = false;
 
-        String nodeId = selectFromMarkerToMarker(tmp, ",", 0);         //node-id
-        String childSensorId = selectFromMarkerToMarker(tmp, ",", 1);  //child-sensor-id
-        String type = selectFromMarkerToMarker(tmp, ",", 2);           //type of var
-        String command = selectFromMarkerToMarker(tmp, ",", 3);        //command
-        String value = selectFromMarkerToMarker(tmp, ",", 4);          //value
+static void mySensorsParse(const QueueRecord& rec) {
+    String tmp = rec.key + "," + rec.value;
 
-        static bool presentBeenStarted = false;
+    String nodeId = selectFromMarkerToMarker(tmp, ",", 0);         //node-id
+    String childSensorId = selectFromMarkerToMarker(tmp, ",", 1);  //child-sensor-id
+    String type = selectFromMarkerToMarker(tmp, ",", 2);           //type of var
+    String command = selectFromMarkerToMarker(tmp, ",", 3);        //command
+    String value = selectFromMarkerToMarker(tmp, ",", 4);          //value
 
-        String key = nodeId + "-" + childSensorId;
-        static String infoJson = "{}";
+    String key = nodeId + "-" + childSensorId;
 
-        if (childSensorId == "255") {
-            if (command == "3") {    //это особое внутреннее сообщение
-                if (type == "11") {  //название ноды
-                    SerialPrint("I", "MySensor", "Node name: " + value);
-                }
-                if (type == "12") {  //версия ноды
-                    SerialPrint("I", "MySensor", "Node version: " + value);
-                }
+    if (childSensorId == "255") {
+        if (command == "3") {    //это особое внутреннее сообщение
+            if (type == "11") {  //название ноды
+                SerialPrint("I", "MySensor", "Node name: " + value);
             }
-        } else {
-            if (command == "0") {  //это презентация
-                presentBeenStarted = true;
-                int num;
-                String widget;
-                String descr;
-                sensorType(type.toInt(), num, widget, descr);
-                if (jsonReadBool(configSetupJson, "gateAuto")) {
-                    if (!isItemAdded(key)) {
-                        addItemAuto(num, key, widget, descr);
-                        descr.replace("#", " ");
-                        SerialPrint("I", "MySensor", "Add new item: " + key + ": " + descr);
-                    } else {
-                        descr.replace("#", " ");
-                        SerialPrint("I", "MySensor", "Item already exist: " + key + ": " + descr);
-                    }
+            if (type == "12") {  //версия ноды
+                SerialPrint("I", "MySensor", "Node version: " + value);
+            }
+        }
+    } else {
+        if (command == "0") {  //это презентация
+            presentBeenStarted = true;
+            int num;
+            String widget;
+            String descr;
+            sensorType(type.toInt(), num, widget, descr);
+            if (settings.gateAuto) {
+                if (!isItemAdded(key)) {
+                    addItemAuto(num, key, widget, descr);
+                    descr.replace("#", " ");
+                    SerialPrint("I", "MySensor", "Add new item: " + key + ": " + descr);
                 } else {
                     descr.replace("#", " ");
-                    SerialPrint("I", "MySensor", "Presentation: " + key + ": " + descr);
+                    SerialPrint("I", "MySensor", "Item already exist: " + key + ": " + descr);
                 }
+            } else {
+                descr.replace("#", " ");
+                SerialPrint("I", "MySensor", "Presentation: " + key + ": " + descr);
             }
-            if (command == "1") {  //это данные
-                if (value != "") {
-                    if (presentBeenStarted) {
-                        presentBeenStarted = false;
-                        SerialPrint("I", "MySensor", "!!!Presentation of node: " + nodeId + " completed successfully!!!");
-                        myNotAsyncActions->make(do_deviceInit);
-                    }
-                    if (mySensorNode != nullptr) {
-                        for (unsigned int i = 0; i < mySensorNode->size(); i++) {
-                            mySensorNode->at(i).onChange(value, key);  //вызываем поочередно все экземпляры, там где подойдет там и выполнится
-                        }
+        }
+        if (command == "1") {  //это данные
+            if (value != "") {
+                if (presentBeenStarted) {
+                    presentBeenStarted = false;
+                    SerialPrint("I", "MySensor", "!!!Presentation of node: " + nodeId + " completed successfully!!!");
+                    myNotAsyncActions->make(do_deviceInit);
+                }
+                if (mySensorNode != nullptr) {
+                    for (unsigned int i = 0; i < mySensorNode->size(); i++) {
+                        mySensorNode->at(i).onChange(value, key);  //вызываем поочередно все экземпляры, там где подойдет там и выполнится
                     }
-                    SerialPrint("I", "MySensor", "node: " + nodeId + ", sensor: " + childSensorId + ", command: " + command + ", type: " + type + ", val: " + value);
                 }
-            }
-            if (command == "2") {  //это запрос значения переменной
-                SerialPrint("I", "MySensor", "Request a variable value");
+                SerialPrint("I", "MySensor", "node: " + nodeId + ", sensor: " + childSensorId + ", command: " + command + ", type: " + type + ", val: " + value);
             }
         }
+        if (command == "2") {  //это запрос значения переменной
+            SerialPrint("I", "MySensor", "Request a variable value");
+        }
+    }
+}
 
-        mysensorBuf = deleteBeforeDelimiter(mysensorBuf, ";");
+//за проход разбирается вся пачка пока хватает времени: при презентации нод записи приходят разом
+void loopMySensorsExecute() {
+    unsigned long start = micros();
+    QueueRecord rec;
+    while (mysensorQueue.pop(rec)) {
+        mySensorsParse(rec);
+        if (micros() - start >= settings.loopBudgetMu) {
+            break;
+        }
     }
 }
 
@@ -1,14 +1,16 @@
 #include "MySensorsDataRead.h"
+#include "Class/EventQueue.h"
 #ifdef MYSENSORS
 
 void receive(const MyMessage &message) {
-    String inMsg = String(message.getSender()) + "," +   //node-id
-                   String(message.getSensor()) + "," +   //child-sensor-id
-                   String(message.getType()) + "," +     //type of var
-                   String(message.getCommand()) + "," +  //command
-                   parseToString(message) + ";";         //value
+    String inMsg = String(message.getSender()) + "," +  //node-id
+                   String(message.getSensor()) + "," +  //child-sensor-id
+                   String(message.getType()) + "," +    //type of var
+                   String(message.getCommand());        //command
 
-    mysensorBuf += inMsg;
+    if (!mysensorQueue.push(inMsg, parseToString(message), ES_MYSENSORS)) {  //value
+        SerialPrint("E", "MySensor", "queue full, lost: " + inMsg);
+    }
 }
 
 String parseToString(const MyMessage &message) {
@@ -1,6 +1,7 @@
 #include "RemoteOrdersUdp.h"
 #include <Arduino.h>
 #include "Global.h"
+#include "BufferExecute.h"
 #include "Class/NotAsync.h"
 #include "Init.h"
 
@@ -9,7 +10,7 @@ AsyncUDP asyncUdp;
 
 void asyncUdpInit() {
 
-    if (!jsonReadBool(configSetupJson, "snaUdp")) {
+    if (!settings.snaUdp) {
         return;
     }
 
@@ -92,11 +93,11 @@ void udpPacketParse(String& data) {
     if (data.indexOf("scen:") != -1) {
         data = deleteBeforeDelimiter(data, ":");
         writeFile(String(DEVICE_SCENARIO_FILE), data);
-        loadScenario();
+        settings.changed("scen");
     }
     else if (data.indexOf("event:") != -1) {
         data = deleteBeforeDelimiter(data, ":");
-        eventBuf += data;
+        eventQueue.pushList(data, ES_UDP);
     }
 }
 
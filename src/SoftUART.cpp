@@ -11,7 +11,7 @@ HardwareSerial* myUART = nullptr;
 #endif
 
 void uartInit() {
-    if (!jsonReadBool(configSetupJson, "uart")) {
+    if (!settings.uart) {
         return;
     }
     if (!myUART) {
@@ -28,7 +28,7 @@ void uartInit() {
 
 void uartHandle() {
     if (myUART) {
-        if (!jsonReadBool(configSetupJson, "uart")) {
+        if (!settings.uart) {
             return;
         }
         static String incStr;
@@ -50,7 +50,7 @@ void parse(String& incStr) {
     incStr.replace("\n", "");
     if (incStr.indexOf("set") != -1) {
         incStr = deleteBeforeDelimiter(incStr, " ");
-        loopCmdAdd(incStr);
+        loopCmdAdd(incStr, ES_UART);
         SerialPrint("I", "=>UART", incStr);
     }
 }
@@ -35,7 +35,7 @@ void handleTelegram() {
                     prevMillis = millis();
                     if (myBot->getNewMessage(msg)) {
                         SerialPrint("->", "Telegram", "chat ID: " + String(msg.sender.id) + ", msg: " + String(msg.text));
-                        if (jsonReadBool(configSetupJson, "autos")) {
+                        if (settings.autos) {
                             jsonWriteInt(configSetupJson, "chatId", msg.sender.id);
                             saveConfig();
                         }
@@ -51,7 +51,7 @@ void telegramMsgParse(String msg) {
     if (msg.indexOf("set") != -1) {
         msg = deleteBeforeDelimiter(msg, "_");
         msg.replace("_", " ");
-        loopCmdAdd(String(msg) + ",");
+        loopCmdAdd(String(msg) + ",", ES_TELEGRAM);
         myBot->sendMessage(jsonReadInt(configSetupJson, "chatId"), "order done");
         SerialPrint("<-", "Telegram", "chat ID: " + String(jsonReadInt(configSetupJson, "chatId")) + ", msg: " + String(msg));
     } else if (msg.indexOf("get") != -1) {
@@ -88,11 +88,11 @@ void sendTelegramMsg() {
 }
 
 bool isEnableTelegramd() {
-    return jsonReadBool(configSetupJson, "telegonof");
+    return settings.telegonof;
 }
 
 bool isTelegramInputOn() {
-    return jsonReadBool(configSetupJson, "teleginput");
+    return settings.teleginput;
 }
 
 String returnListOfParams() {
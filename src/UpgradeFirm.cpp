@@ -156,6 +156,7 @@ bool upgradeBuild() {
 }
 
 void restartEsp() {
+    flushStore();
     Serial.println("Restart ESP....");
     delay(1000);
     ESP.restart();
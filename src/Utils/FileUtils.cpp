@@ -2,7 +2,7 @@
 
 #include "FileSystem.h"
 #include "Utils/StringUtils.h"
-#include "Utils\SerialPrint.h"
+#include "Utils/SerialPrint.h"
 
 const String filepath(const String& filename) {
     return filename.startsWith("/") ? filename : "/" + filename;
@@ -51,10 +51,78 @@ String jsonWriteFloat(String& json, String name, float value) {
     return json;
 }
 
+JsonBatch::JsonBatch(String& json) : _json(json), _root(_jsonBuffer.parseObject(json)), _changed(false) {}
+
+JsonBatch::~JsonBatch() {
+    commit();
+}
+
+JsonBatch& JsonBatch::setStr(const String& name, const String& value) {
+    _root[name] = value;
+    _changed = true;
+    return *this;
+}
+
+JsonBatch& JsonBatch::setInt(const String& name, int value) {
+    _root[name] = value;
+    _changed = true;
+    return *this;
+}
+
+JsonBatch& JsonBatch::setFloat(const String& name, float value) {
+    _root[name] = value;
+    _changed = true;
+    return *this;
+}
+
+void JsonBatch::commit() {
+    if (!_changed) {
+        return;
+    }
+    _json = "";
+    _root.printTo(_json);
+    _changed = false;
+}
+
 void saveConfig() {
     writeFile(String("config.json"), configSetupJson);
 }
 
+StoreStats storeStats = {0, 0};
+
+static bool storePending = false;
+static unsigned long storeFirstChange;
+static unsigned long storeLastChange;
+
 void saveStore() {
-    writeFile(String("store.json"), configStoreJson);
+    storeStats.saves++;
+    if (!storeValues.isDirty()) {
+        return;
+    }
+    unsigned long now = millis();
+    if (!storePending) {
+        storePending = true;
+        storeFirstChange = now;
+    }
+    storeLastChange = now;
+}
+
+void storeLoop() {
+    if (!storePending) {
+        return;
+    }
+    unsigned long now = millis();
+    if (now - storeLastChange >= settings.storeQuietMs || now - storeFirstChange >= settings.storeMaxDelayMs) {
+        flushStore();
+    }
+}
+
+void flushStore() {
+    storePending = false;
+    if (!storeValues.isDirty()) {
+        return;
+    }
+    writeFile(String("store.json"), storeValues.toJson());
+    storeValues.clearDirty();
+    storeStats.writes++;
 }
\ No newline at end of file
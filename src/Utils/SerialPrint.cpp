@@ -1,4 +1,4 @@
-#include "Utils\SerialPrint.h"
+#include "Utils/SerialPrint.h"
 
 #include "Global.h"
 
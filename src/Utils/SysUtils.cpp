@@ -89,7 +89,7 @@ const String getMacAddress() {
 
 #ifdef ESP8266
 void setLedStatus(LedStatus_t status) {
-    if (jsonReadBool(configSetupJson, "blink") == 1) {
+    if (settings.blink) {
         pinMode(LED_PIN, OUTPUT);
         switch (status) {
             case LED_OFF:
@@ -113,7 +113,7 @@ void setLedStatus(LedStatus_t status) {
 }
 #else
 void setLedStatus(LedStatus_t status) {
-    if (jsonReadBool(configSetupJson, "blink") == 1) {
+    if (settings.blink) {
         pinMode(LED_PIN, OUTPUT);
         switch (status) {
             case LED_OFF:
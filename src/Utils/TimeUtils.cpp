@@ -227,7 +227,7 @@ void timeInit() {
             static String prevTime;
             if (prevTime != timenow) {
                 prevTime = timenow;
-                jsonWriteStr(configLiveJson, "timenow", timenow);
+                liveValues.setStr("timenow", timenow);
                 eventGen2("timenow", timenow);
                 SerialPrint("I", F("NTP"), timenow);
             }
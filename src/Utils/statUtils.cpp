@@ -3,6 +3,7 @@
 #include <Arduino.h>
 #include <EEPROM.h>
 
+#include "Class/KvStore.h"
 #include "Global.h"
 #include "ItemsList.h"
 
@@ -67,9 +68,10 @@ String addNewDevice() {
         String json = "{}";
         String mac = WiFi.macAddress().c_str();
         //==============================================
-        jsonWriteStr(json, "uniqueId", mac);
-        jsonWriteStr(json, "name", FIRMWARE_NAME);
-        jsonWriteStr(json, "model", getChipId());
+        JsonBatch(json)
+            .setStr("uniqueId", mac)
+            .setStr("name", FIRMWARE_NAME)
+            .setStr("model", getChipId());
         //==============================================
         http.begin(client, serverIP + F(":8082/api/devices/"));
         http.setAuthorization("admin", "admin");
@@ -173,16 +175,11 @@ String getUptimeTotal() {
 }
 
 uint8_t getNextNumber(String file) {
-    uint8_t number = readFile(file, 100).toInt();
-    number++;
-    removeFile(file);
-    addFile(file, String(number));
-    return number;
+    return kvStore.increment(file);
 }
 
 uint8_t getCurrentNumber(String file) {
-    uint8_t number = readFile(file, 100).toInt();
-    return number;
+    return kvStore.getInt(file);
 }
 
 #ifdef ESP8266
@@ -281,10 +278,11 @@ void updateDeviceList() {
         String json = "{}";
         String mac = WiFi.macAddress().c_str();
         //===============================================
-        jsonWriteStr(json, "uniqueId", mac);
-        jsonWriteStr(json, "name", FIRMWARE_NAME);
-        jsonWriteStr(json, "model", FIRMWARE_VERSION);
-        jsonWriteInt(json, "id", getId("statid.txt"));
+        JsonBatch(json)
+            .setStr("uniqueId", mac)
+            .setStr("name", FIRMWARE_NAME)
+            .setStr("model", FIRMWARE_VERSION)
+            .setInt("id", getId("statid.txt"));
         //===============================================
         http.begin(client, "http://") + serverIP + F(":8082/api/devices/" + mac + "/");
         http.setAuthorization("admin", "admin");
@@ -1,5 +1,6 @@
 #include "Web.h"
 
+#include "BufferExecute.h"
 #include "Class/NotAsync.h"
 #include "Global.h"
 #include "Init.h"
@@ -18,6 +19,21 @@ bool parseRequestForPreset(AsyncWebServerRequest* request, uint8_t& preset) {
 }
 
 void web_init() {
+    settings.onChange([](const String& name) {
+        if (name == "scen") {
+            loadScenario();
+        } else if (name == "MqttIn") {
+            if (settings.mqttIn) {
+                mqtt.subscribe((mqttPrefix + "/+/+/event").c_str());
+                mqtt.subscribe((mqttPrefix + "/+/+/info").c_str());
+            }
+#ifdef EnableUart
+        } else if (name == "uart") {
+            uartInit();
+#endif
+        }
+    });
+
     server.on("/set", HTTP_GET, [](AsyncWebServerRequest* request) {
         //==============================set.device.json====================================================================================================
         if (request->hasArg(F("addItem"))) {
@@ -56,29 +72,26 @@ void web_init() {
 
         if (request->hasArg(F("scen"))) {
             bool value = request->getParam(F("scen"))->value().toInt();
-            jsonWriteBool(configSetupJson, F("scen"), value);
+            settings.setBool("scen", value);
             saveConfig();
-            loadScenario();
             request->send(200);
         }
 
         if (request->hasArg(F("sceninit"))) {
-            loadScenario();
+            settings.changed("scen");
             request->send(200);
         }
 
         if (request->hasArg(F("MqttIn"))) {
             bool value = request->getParam(F("MqttIn"))->value().toInt();
-            jsonWriteBool(configSetupJson, "MqttIn", value);
+            settings.setBool("MqttIn", value);
             saveConfig();
-            mqtt.subscribe((mqttPrefix + "/+/+/event").c_str());
-            mqtt.subscribe((mqttPrefix + "/+/+/info").c_str());
             request->send(200);
         }
 
         if (request->hasArg(F("MqttOut"))) {
             bool value = request->getParam(F("MqttOut"))->value().toInt();
-            jsonWriteBool(configSetupJson, F("MqttOut"), value);
+            settings.setBool("MqttOut", value);
             saveConfig();
             request->send(200);
         }
@@ -156,19 +169,21 @@ void web_init() {
 
         if (request->hasArg(F("blink"))) {
             bool value = request->getParam(F("blink"))->value().toInt();
-            jsonWriteBool(configSetupJson, F("blink"), value);
+            settings.setBool("blink", value);
             saveConfig();
             request->send(200);
         }
 
         if (request->hasArg(F("reqReset"))) {
             String tmp = "{}";
-            jsonWriteStr(tmp, "title", F("<button class=\"close\" onclick=\"toggle('reset-block')\">×</button>Вы действительно хотите перезагрузить устройство?<a href=\"#\" class=\"btn btn-block btn-danger\" onclick=\"send_request(this, '/set?reset');setTimeout(function(){ location.href='/?set.device'; }, 15000);html('reset-block','<span class=loader></span>Идет перезагрузка устройства')\">Перезагрузить</a>"));
-            jsonWriteStr(tmp, "class", "pop-up");
+            JsonBatch(tmp)
+                .setStr("title", F("<button class=\"close\" onclick=\"toggle('reset-block')\">×</button>Вы действительно хотите перезагрузить устройство?<a href=\"#\" class=\"btn btn-block btn-danger\" onclick=\"send_request(this, '/set?reset');setTimeout(function(){ location.href='/?set.device'; }, 15000);html('reset-block','<span class=loader></span>Идет перезагрузка устройства')\">Перезагрузить</a>"))
+                .setStr("class", "pop-up");
             request->send(200, "text/html", tmp);
         }
 
         if (request->hasArg(F("reset"))) {
+            flushStore();
             ESP.restart();
             request->send(200);
         }
@@ -248,8 +263,9 @@ void web_init() {
             String buf = "<button class=\"close\" onclick=\"toggle('my-block')\">×</button>" + getStateStr();
 
             String payload = "{}";
-            jsonWriteStr(payload, "title", buf);
-            jsonWriteStr(payload, "class", "pop-up");
+            JsonBatch(payload)
+                .setStr("title", buf)
+                .setStr("class", "pop-up");
 
             request->send(200, "text/html", payload);
         }
@@ -262,7 +278,7 @@ void web_init() {
         }
         if (request->hasArg("autos")) {
             bool value = request->getParam("autos")->value().toInt();
-            jsonWriteBool(configSetupJson, "autos", value);
+            settings.setBool("autos", value);
             saveConfig();
             request->send(200);
         }
@@ -273,13 +289,13 @@ void web_init() {
         }
         if (request->hasArg("telegonof")) {
             bool value = request->getParam("telegonof")->value().toInt();
-            jsonWriteBool(configSetupJson, "telegonof", value);
+            settings.setBool("telegonof", value);
             saveConfig();
             request->send(200);
         }
         if (request->hasArg("teleginput")) {
             bool value = request->getParam("teleginput")->value().toInt();
-            jsonWriteBool(configSetupJson, "teleginput", value);
+            settings.setBool("teleginput", value);
             saveConfig();
             request->send(200);
         }
@@ -291,16 +307,13 @@ void web_init() {
         }
         if (request->hasArg("uart")) {
             bool value = request->getParam("uart")->value().toInt();
-            jsonWriteBool(configSetupJson, "uart", value);
+            settings.setBool("uart", value);
             saveConfig();
-#ifdef EnableUart
-            uartInit();
-#endif
             request->send(200);
         }
         if (request->hasArg("uartEvents")) {
             bool value = request->getParam("uartEvents")->value().toInt();
-            jsonWriteBool(configSetupJson, "uartEvents", value);
+            settings.setBool("uartEvents", value);
             saveConfig();
             request->send(200);
         }
@@ -340,8 +353,7 @@ void web_init() {
         if (request->hasArg("order")) {
             String order = request->getParam("order")->value();
             order.replace("_", " ");
-            orderBuf += order + ",";
-            request->send(200);
+            request->send(orderAdd(order, ES_WEB) ? 200 : 503);
         }
 
         if (request->hasArg("grafmax")) {
@@ -355,7 +367,7 @@ void web_init() {
 
         if (request->hasArg("gateAuto")) {
             bool value = request->getParam("gateAuto")->value().toInt();
-            jsonWriteBool(configSetupJson, "gateAuto", value);
+            settings.setBool("gateAuto", value);
             saveConfig();
             request->send(200);
         }
@@ -396,8 +408,9 @@ void web_init() {
         }
 
         String tmp = "{}";
-        jsonWriteStr(tmp, "title", "<button class=\"close\" onclick=\"toggle('my-block')\">×</button>" + msg);
-        jsonWriteStr(tmp, "class", "pop-up");
+        JsonBatch(tmp)
+            .setStr("title", "<button class=\"close\" onclick=\"toggle('my-block')\">×</button>" + msg)
+            .setStr("class", "pop-up");
         request->send(200, "text/html", tmp);
     });
 
@@ -1,8 +1,14 @@
 #include "HttpServer.h"
+
+#include <memory>
+
 #include "BufferExecute.h"
+#include "Class/LogQuery.h"
+#include "Class/WebSnapshot.h"
 #include "Utils/FileUtils.h"
 #include "Utils/WebUtils.h"
 #include "FSEditor.h"
+#include "items/vLogging.h"
 
 namespace HttpServer {
 
@@ -12,6 +18,27 @@ void initOta();
 void initMDNS();
 void initWS();
 
+//снимок старше WEB_SNAPSHOT_MIN_MS собирается в loop, до тех пор сервер спрашивает снова
+static void sendSnapshot(AsyncWebServerRequest *request, WebSnapshot *snapshot) {
+    uint32_t build = snapshot->want();
+    std::shared_ptr<String> json = std::make_shared<String>();
+    if (snapshot->get(build, *json)) {
+        request->send(200, "application/json", *json);
+        return;
+    }
+    request->send(request->beginChunkedResponse("application/json", [snapshot, build, json](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+        if (!index && !json->length() && !snapshot->get(build, *json)) {
+            return RESPONSE_TRY_AGAIN;
+        }
+        size_t len = json->length() - index;
+        if (len > maxLen) {
+            len = maxLen;
+        }
+        memcpy(buffer, json->c_str() + index, len);
+        return len;
+    }));
+}
+
 void init() {
     String login = jsonReadStr(configSetupJson, "weblogin");
     String pass = jsonReadStr(configSetupJson, "webpass");
@@ -46,13 +73,42 @@ void init() {
 
     // динамические данные
     server.on("/config.live.json", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "application/json", configLiveJson);
+        sendSnapshot(request, &liveSnapshot);
+    });
+
+    server.on("/items.stats.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        sendSnapshot(request, &itemsSnapshot);
     });
 
     server.on("/config.store.json", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "application/json", configStoreJson);
+        sendSnapshot(request, &storeSnapshot);
     });
 
+#ifdef EnableLogging
+    // история лога: /logs/query?key=&from=&to=&points=, ответ в формате графика по частям
+    // лог читается в loop, см. LogQuery
+    server.on("/logs/query", HTTP_GET, [](AsyncWebServerRequest *request) {
+        if (myLogging == nullptr || myLogging->find(request->arg("key")) == nullptr) {
+            request->send(404);
+            return;
+        }
+        uint32_t from = request->hasArg("from") ? request->arg("from").toInt() : 0;
+        uint32_t to = request->hasArg("to") ? request->arg("to").toInt() : UINT32_MAX;
+        size_t points = request->hasArg("points") ? request->arg("points").toInt() : LOG_CHART_POINTS;
+        if (points > LOG_CHART_POINTS) {
+            points = LOG_CHART_POINTS;
+        }
+        std::shared_ptr<LogQuery> query = std::make_shared<LogQuery>(request->arg("key"), from, to, points);
+        if (!logQueryAdd(query)) {
+            request->send(503, "text/html", "busy");
+            return;
+        }
+        request->send(request->beginChunkedResponse("application/json", [query](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return query->fill(buffer, maxLen);
+        }));
+    });
+#endif
+
     // данные не являющиеся событиями
     server.on("/config.option.json", HTTP_GET, [](AsyncWebServerRequest *request) {
         request->send(200, "application/json", configOptionJson);
@@ -66,8 +122,11 @@ void init() {
     server.on("/cmd", HTTP_GET, [](AsyncWebServerRequest *request) {
         String cmdStr = request->getParam("command")->value();
         SerialPrint("I","WebServer","do: " + cmdStr);
-        loopCmdAdd(cmdStr);
-        request->send(200, "text/html", "OK");
+        if (loopCmdAdd(cmdStr, ES_WEB)) {
+            request->send(200, "text/html", "OK");
+        } else {
+            request->send(503, "text/html", "queue full");
+        }
     });
 
     server.begin();
@@ -165,6 +224,7 @@ void initMDNS() {
 void initOta() {
 #ifdef OTA_UPDATES_ENABLED
     ArduinoOTA.onStart([]() {
+        flushStore();
         events.send("Update Start", "ota");
     });
     ArduinoOTA.onEnd([]() {
@@ -20,10 +20,12 @@ void createWidget(String descr, String page, String order, String filename, Stri
     descr.replace("#", " ");
     page.replace("#", " ");
 
-    jsonWriteStr(buf, "page", page);
-    jsonWriteStr(buf, "order", order);
-    jsonWriteStr(buf, "descr", descr);
-    jsonWriteStr(buf, "topic", prex + "/" + topic);
+    JsonBatch batch(buf);
+    batch.setStr("page", page)
+        .setStr("order", order)
+        .setStr("descr", descr)
+        .setStr("topic", prex + "/" + topic);
+    batch.commit();
 
 #ifdef LAYOUT_IN_RAM
     all_widgets += widget + "\r\n";
@@ -43,14 +45,16 @@ void createWidgetParam(String widget, String page, String pageNumber, String fil
     widget.replace("#", " ");
     page.replace("#", " ");
 
-    jsonWriteStr(buf, "page", page);
-    jsonWriteStr(buf, "order", pageNumber);
-    jsonWriteStr(buf, "descr", widget);
-    jsonWriteStr(buf, "topic", prex + "/" + topic);
+    JsonBatch batch(buf);
+    batch.setStr("page", page)
+        .setStr("order", pageNumber)
+        .setStr("descr", widget)
+        .setStr("topic", prex + "/" + topic);
 
-    if (name1) jsonWriteStr(buf, name1, param1);
-    if (name2) jsonWriteStr(buf, name2, param2);
-    if (name3) jsonWriteStr(buf, name3, param3);
+    if (name1) batch.setStr(name1, param1);
+    if (name2) batch.setStr(name2, param2);
+    if (name3) batch.setStr(name3, param3);
+    batch.commit();
 
 #ifdef LAYOUT_IN_RAM
     all_widgets += widget + "\r\n";
@@ -69,12 +73,14 @@ void createChart(String widget, String page, String pageNumber, String filename,
     widget.replace("#", " ");
     page.replace("#", " ");
 
-    jsonWriteStr(buf, "page", page);
-    jsonWriteStr(buf, "order", pageNumber);
-    //jsonWriteStr(widget, "descr", widget_name);
-    jsonWriteStr(buf, "series", widget);
-    jsonWriteStr(buf, "maxCount", maxCount);
-    jsonWriteStr(buf, "topic", prex + "/" + topic);
+    JsonBatch batch(buf);
+    batch.setStr("page", page)
+        .setStr("order", pageNumber)
+        //.setStr("descr", widget_name)
+        .setStr("series", widget)
+        .setStr("maxCount", maxCount)
+        .setStr("topic", prex + "/" + topic);
+    batch.commit();
 
 #ifdef LAYOUT_IN_RAM
     all_widgets += widget + "\r\n";
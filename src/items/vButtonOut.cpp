@@ -17,7 +17,7 @@ ButtonOut::ButtonOut(String pin, boolean inv, String key, String type) {
     if (_pin != "") {
         pinMode(_pin.toInt(), OUTPUT);
     }
-    int state = jsonReadInt(configStoreJson, key); //прочитали из памяти 
+    int state = storeValues.getInt(key); //прочитали из памяти 
     this->execute(String(state)); //установили это состояние
 #endif
 #ifdef GATE_MODE
@@ -49,7 +49,7 @@ void ButtonOut::execute(String state) {
 //не получили обратную связь - сделали кнопку красной
 #endif
     eventGen2(_key, state);
-    jsonWriteInt(configStoreJson, _key, state.toInt());
+    storeValues.setInt(_key, state.toInt());
     saveStore();
     publishStatus(_key, state);
 }
@@ -68,13 +68,10 @@ void buttonOut() {
 
     myLineParsing.clear();
 
-    buttonOut_EnterCounter++;
-    addKey(key, buttonOut_KeyList, buttonOut_EnterCounter);
-
     static bool firstTime = true;
     if (firstTime) myButtonOut = new MyButtonOutVector();
     firstTime = false;
-    myButtonOut->push_back(ButtonOut(pin, invb, key, type));
+    myButtonOut->add(key, ButtonOut(pin, invb, key, type));
 
     sCmd.addCommand(key.c_str(), buttonOutExecute);
 }
@@ -83,11 +80,10 @@ void buttonOutExecute() {
     String key = sCmd.order();
     String state = sCmd.next();
 
-    int number = getKeyNum(key, buttonOut_KeyList);
-
     if (myButtonOut != nullptr) {
-        if (number != -1) {
-            myButtonOut->at(number).execute(state);
+        ButtonOut* item = myButtonOut->find(key);
+        if (item != nullptr) {
+            item->execute(state);
         }
     }
 }
@@ -48,16 +48,10 @@ void countDown() {
     String key = myLineParsing.gkey();
     myLineParsing.clear();
 
-    countDown_EnterCounter++;
-    addKey(key, countDown_KeyList, countDown_EnterCounter);
-
-    Serial.println(countDown_EnterCounter);
-    Serial.println(countDown_KeyList);
-
     static bool firstTime = true;
     if (firstTime) myCountDown = new MyCountDownVector();
     firstTime = false;
-    myCountDown->push_back(CountDownClass(key));
+    myCountDown->add(key, CountDownClass(key));
 
     sCmd.addCommand(key.c_str(), countDownExecute);
 }
@@ -70,11 +64,10 @@ void countDownExecute() {
         value = getValue(value);
     }
 
-    int number = getKeyNum(key, countDown_KeyList);
-
     if (myCountDown != nullptr) {
-        if (number != -1) {
-            myCountDown->at(number).execute(value.toInt());
+        CountDownClass* item = myCountDown->find(key);
+        if (item != nullptr) {
+            item->execute(value.toInt());
         }
     }
 }
@@ -7,8 +7,9 @@
 #include "BufferExecute.h"
 #include <Arduino.h>
 
-ImpulsOutClass::ImpulsOutClass(unsigned int impulsPin) {
+ImpulsOutClass::ImpulsOutClass(unsigned int impulsPin, String key) {
     _impulsPin = impulsPin;
+    _key = key;
     pinMode(impulsPin, OUTPUT);
 }
 
@@ -45,13 +46,10 @@ void impuls() {
     String pin = myLineParsing.gpin();
     myLineParsing.clear();
 
-    impuls_EnterCounter++;
-    addKey(key, impuls_KeyList, impuls_EnterCounter);
-
     static bool firstTime = true;
     if (firstTime) myImpulsOut = new MyImpulsOutVector();
     firstTime = false;
-    myImpulsOut->push_back(ImpulsOutClass(pin.toInt()));
+    myImpulsOut->add(key, ImpulsOutClass(pin.toInt(), key));
 
     sCmd.addCommand(key.c_str(), impulsExecute);
 }
@@ -61,11 +59,10 @@ void impulsExecute() {
     String impulsPeriod = sCmd.next();
     String impulsCount = sCmd.next();
 
-    int number = getKeyNum(key, impuls_KeyList);
-
     if (myImpulsOut != nullptr) {
-        if (number != -1) {
-            myImpulsOut->at(number).execute(impulsPeriod.toInt(), impulsCount.toInt());
+        ImpulsOutClass* item = myImpulsOut->find(key);
+        if (item != nullptr) {
+            item->execute(impulsPeriod.toInt(), impulsCount.toInt());
         }
     }
 }
@@ -12,7 +12,7 @@
 //this class save date to flash
 Input::Input(String key, String widget) {
     _key = key;
-    String value = jsonReadStr(configStoreJson, key);
+    String value = storeValues.getStr(key);
 
     if (value == "") {
         if (widget.indexOf("Digit") != -1) {
@@ -29,7 +29,7 @@ Input::~Input() {}
 
 void Input::execute(String value) {
     eventGen2(_key, value);
-    jsonWriteStr(configStoreJson, _key, value);
+    storeValues.setStr(_key, value);
     saveStore();
     publishStatus(_key, value);
 }
@@ -42,13 +42,10 @@ void input() {
     String key = myLineParsing.gkey();
     myLineParsing.clear();
 
-    input_EnterCounter++;
-    addKey(key, input_KeyList, input_EnterCounter);
-
     static bool firstTime = true;
     if (firstTime) myInput = new MyInputVector();
     firstTime = false;
-    myInput->push_back(Input(key, widget));
+    myInput->add(key, Input(key, widget));
 
     sCmd.addCommand(key.c_str(), inputExecute);
 }
@@ -69,11 +66,10 @@ void inputExecute() {
         }
     }
 
-    int number = getKeyNum(key, input_KeyList);
-
     if (myInput != nullptr) {
-        if (number != -1) {
-            myInput->at(number).execute(value);
+        Input* item = myInput->find(key);
+        if (item != nullptr) {
+            item->execute(value);
         }
     }
 }
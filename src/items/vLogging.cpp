@@ -3,17 +3,45 @@
 #include <Arduino.h>
 
 #include "BufferExecute.h"
+#include "Class/ChartWriter.h"
 #include "Class/LineParsing.h"
 #include "FileSystem.h"
 #include "Global.h"
 #include "items/vLogging.h"
 
-LoggingClass::LoggingClass(String interval, unsigned int maxPoints, String loggingValueKey, String key, String startState, bool savedFromWeb) {
+LoggingClass::LoggingClass(String interval, unsigned int maxPoints, size_t rollup5m, size_t rollup1h, String loggingValueKey, String key, String startState, bool savedFromWeb) : _log("/logs/" + key + LOG_FILE_EXT, maxPoints), _rollup5m("/logs/" + key + ".5m", rollup5m, 300), _rollup1h("/logs/" + key + ".1h", rollup1h, 3600) {
     _interval = interval;
     _maxPoints = maxPoints;
     _loggingValueKey = loggingValueKey;
     _key = key;
 
+    //лог от прошлых версий в текстовом виде
+    if (FileFS.exists("/logs/" + _key + ".txt")) {
+        _log.importText("/logs/" + _key + ".txt");
+    }
+#ifdef LOG_COMPRESSED
+    //несжатый лог, если сжатие включили позже
+    if (FileFS.exists("/logs/" + _key + ".bin")) {
+        RingLog ring("/logs/" + _key + ".bin", maxPoints);
+        ring.forEach([this](const RingLogRecord& rec) {
+            _log.append(rec.time, rec.value);
+        });
+        removeFile("/logs/" + _key + ".bin");
+    }
+#endif
+
+    //незаконченные интервалы прореживания были только в памяти - досчитываем их из сырых точек
+    uint32_t from5m = _rollup5m.resumeTime();
+    uint32_t from1h = _rollup1h.resumeTime();
+    _log.forEach([this, from5m, from1h](const RingLogRecord& rec) {
+        if (rec.time >= from5m) {
+            _rollup5m.add(rec.time, rec.value);
+        }
+        if (rec.time >= from1h) {
+            _rollup1h.add(rec.time, rec.value);
+        }
+    });
+
     if (_interval.indexOf(":") != -1) {
         _type = 3;  //тип 3 логгирование в указанное время
         _intervalSec = 1000;
@@ -38,27 +66,27 @@ LoggingClass::LoggingClass(String interval, unsigned int maxPoints, String loggi
 
 LoggingClass::~LoggingClass() {}
 
+//период вызова выдерживает itemScheduler, см. interval()
 void LoggingClass::loop() {
-    if (_intervalSec > 0) {
-        currentMillis = millis();
-        difference = currentMillis - prevMillis;
-        if (difference >= _intervalSec) {
-            prevMillis = millis();
-            if (_type == 1) {
-                execute("");
-            } else if (_type == 2) {
-            } else if (_type == 3) {
-                String timenow = timeNow->getTimeWOsec();
-                static String prevTime;
-                if (prevTime != timenow) {
-                    prevTime = timenow;
-                    if (_interval == timenow) execute("");
-                }
-            }
+    if (_type == 1) {
+        execute("");
+    } else if (_type == 3) {
+        String timenow = timeNow->getTimeWOsec();
+        static String prevTime;
+        if (prevTime != timenow) {
+            prevTime = timenow;
+            if (_interval == timenow) execute("");
         }
     }
 }
 
+unsigned long LoggingClass::interval() const {
+    if (_type == 1 || _type == 3) {
+        return _intervalSec;
+    }
+    return ITEM_PASSIVE;  //логгирование по событию работает через execute()
+}
+
 void LoggingClass::execute(String keyOrValue) {
     String loggingValue = "";
     if (_type == 1) {  //тип 1 логгирование через период
@@ -89,46 +117,79 @@ void LoggingClass::execute(String keyOrValue) {
         }
     }
 
-    String filename = "/logs/" + _key + ".txt";
-
-    size_t cnt = countLines(filename);
-    size_t sz = getFileSize(filename);
+    if (loggingValue != "" && timeNow->hasTimeSynced()) {
+        uint32_t time = timeNow->getTimeUnix().toInt();
+        float value = loggingValue.toFloat();
+        _log.append(time, value);
+        _rollup5m.add(time, value);
+        _rollup1h.add(time, value);
+    }
+    SerialPrint("I", "Logging", "'" + _key + "' points " + String(_log.count()));
 
-    SerialPrint("I", "Logging", "http://" + WiFi.localIP().toString() + filename + " lines " + String(cnt, DEC) + ", size " + String(sz));
+    ChartWriter writer(0, [this](const char* data, size_t length) {
+        publishChart(_key, data, length);
+    });
+    writer.add(timeNow->getTimeUnix().toInt(), loggingValue.toFloat());
+    writer.finish();
+}
 
-    if ((cnt > _maxPoints + 1)) {
-        removeFile(filename);
-        SerialPrint("E", "Logging", "file been remooved: " + filename + " " + String(cnt) + ">" + String(_maxPoints));
-        cnt = 0;
+//из сырых точек и уровней прореживания выбирается самый подробный, который покрывает
+//начало диапазона и дает не больше LOG_CHART_POINTS точек; сырые точки отдаются как count=1
+void LoggingClass::forEachInRange(uint32_t from, uint32_t to, RollupHandler_t handler) {
+    if (to < from) {
+        return;
     }
-
-    if (loggingValue != "") {
-        if (cnt >= _maxPoints) {                         //удаляем старую строку и добавляем новую
-            String logData = readFile(filename, 20480);  //10240
-            SerialPrint("I", "Logging", "Free heap " + String(ESP.getFreeHeap()));
-            if (logData == "large") {
-                SerialPrint("E", "Logging", "File is very large");
+    //0 - сырые точки, дальше уровни от подробного к грубому
+    RollupTier* tiers[] = {nullptr, &_rollup5m, &_rollup1h};
+    int best = -1;
+    int longest = -1;
+    uint32_t longestTime = 0;
+    for (int i = 0; i < 3; i++) {
+        uint32_t oldest;
+        uint32_t period;
+        if (tiers[i]) {
+            oldest = tiers[i]->oldestTime();
+            period = tiers[i]->period();
+        } else {
+            oldest = _log.oldestTime();
+            if (_type == 1) {
+                period = _intervalSec / 1000;
+            } else {
+                uint32_t now = timeNow->getTimeUnix().toInt();
+                period = _log.count() > 1 && now > oldest ? (now - oldest) / _log.count() : 1;
             }
+        }
+        if (!oldest) {
+            continue;
+        }
+        if (longest < 0 || oldest < longestTime) {
+            longest = i;
+            longestTime = oldest;
+        }
+        if (oldest <= from && (to - from) / (period ? period : 1) <= LOG_CHART_POINTS) {
+            best = i;
+            break;
+        }
+    }
+    if (best < 0) {
+        best = longest;  //ни один не подходит - тот, где история длиннее
+    }
 
-            logData = deleteBeforeDelimiter(logData, "\r\n");
-
-            if (timeNow->hasTimeSynced()) {
-                logData += timeNow->getTimeUnix() + " " + loggingValue + "\r\n";
-
-                writeFile(filename, logData);
+    if (best > 0) {
+        uint32_t period = tiers[best]->period();
+        tiers[best]->forEach([&](const RollupRecord& rec) {
+            if (rec.time + period > from && rec.time <= to) {
+                handler(rec);
             }
-        } else {  //просто добавляем новую строку
-            if (timeNow->hasTimeSynced()) {
-                addFileLn(filename, timeNow->getTimeUnix() + " " + loggingValue);
+        });
+    } else if (best == 0) {
+        _log.forEach([&](const RingLogRecord& point) {
+            if (point.time >= from && point.time <= to) {
+                RollupRecord rec = {point.time, point.value, point.value, point.value, 1};
+                handler(rec);
             }
-        }
+        });
     }
-
-    String buf = "{}";
-    jsonWriteInt(buf, "x", timeNow->getTimeUnix().toInt());
-    jsonWriteFloat(buf, "y1", loggingValue.toFloat());
-    buf = "{\"status\":[" + buf + "]}";
-    publishChart(_key, buf);
 }
 
 MyLoggingVector* myLogging = nullptr;
@@ -140,17 +201,17 @@ void logging() {
     String interval = myLineParsing.gint();
     String maxcnt = myLineParsing.gcnt();
     String startState = myLineParsing.gstate();
+    String rollup5m = myLineParsing.gr5m();
+    String rollup1h = myLineParsing.gr1h();
     myLineParsing.clear();
 
-    logging_KeyList += key + ",";
-
-    logging_EnterCounter++;
-    addKey(key, logging_KeyList, logging_EnterCounter);
-
     static bool firstTime = true;
     if (firstTime) myLogging = new MyLoggingVector();
     firstTime = false;
-    myLogging->push_back(LoggingClass(interval, maxcnt.toInt(), loggingValueKey, key, startState, savedFromWeb));
+    myLogging->add(key, LoggingClass(interval, maxcnt.toInt(),
+                                     rollup5m != "" ? rollup5m.toInt() : LOG_ROLLUP_5MIN,
+                                     rollup1h != "" ? rollup1h.toInt() : LOG_ROLLUP_HOUR,
+                                     loggingValueKey, key, startState, savedFromWeb));
 
     sCmd.addCommand(key.c_str(), loggingExecute);
 }
@@ -158,66 +219,14 @@ void logging() {
 void loggingExecute() {
     String key = sCmd.order();
     String value = sCmd.next();
-    int number = getKeyNum(key, logging_KeyList);
     if (myLogging != nullptr) {
-        if (number != -1) {
-            myLogging->at(number).execute(value);
+        LoggingClass* item = myLogging->find(key);
+        if (item != nullptr) {
+            item->execute(value);
         }
     }
 }
 
-void choose_log_date_and_send() {
-    String all_line = logging_KeyList;
-    while (all_line.length() != 0) {
-        String tmp = selectToMarker(all_line, ",");
-        sendLogData("/logs/" + tmp + ".txt", tmp);
-        all_line = deleteBeforeDelimiter(all_line, ",");
-    }
-}
-
-void sendLogData(String file, String topic) {
-    File configFile = FileFS.open(file, "r");
-    if (!configFile) {
-        return;
-    }
-    configFile.seek(0, SeekSet);
-    int i = 0;
-    String buf = "{}";
-    String json_array;
-    String unix_time;
-    String value;
-    unsigned int psn;
-    unsigned int sz = configFile.size();
-    do {
-        i++;
-        psn = configFile.position();
-        String line = configFile.readStringUntil('\n');
-        unix_time = selectToMarker(line, " ");
-        jsonWriteInt(buf, "x", unix_time.toInt());
-        value = deleteBeforeDelimiter(line, " ");
-        jsonWriteFloat(buf, "y1", value.toFloat());
-        if (unix_time != "" || value != "") {
-            json_array += buf + ",";
-        }
-        int grafmax = jsonReadInt(configSetupJson, "grafmax");
-        if (grafmax != 0) {
-            if (i >= grafmax) {
-                json_array = "{\"status\":[" + json_array + "]}";
-                json_array.replace("},]}", "}]}");
-                publishChart(topic, json_array);
-                json_array = "";
-                i = 0;
-            }
-        }
-    } while (psn < sz);
-
-    configFile.close();
-
-    json_array = "{\"status\":[" + json_array + "]}";
-    json_array.replace("},]}", "}]}");
-    publishChart(topic, json_array);
-}
-
 void cleanLogAndData() {
 #ifdef ESP8266
     auto dir = FileFS.openDir("logs");
@@ -228,6 +237,7 @@ void cleanLogAndData() {
     }
 #endif
     removeFile("store.json");
-    configStoreJson = "";
+    storeValues.clear();
+    storeValues.clearDirty();
 }
 #endif
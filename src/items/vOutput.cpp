@@ -11,14 +11,14 @@
 
 Output::Output(String key) {
     _key = key;
-    String value = jsonReadStr(configLiveJson, key);
+    String value = liveValues.getStr(key);
     this->execute(value);
 }
 Output::~Output() {}
 
 void Output::execute(String value) {
     eventGen2(_key, value);
-    jsonWriteStr(configLiveJson, _key, value);
+    liveValues.setStr(_key, value);
     publishStatus(_key, value);
     //publishLastUpdateTime(_key, timeNow->getTime());
 }
@@ -30,13 +30,10 @@ void output() {
     String key = myLineParsing.gkey();
     myLineParsing.clear();
 
-    output_EnterCounter++;
-    addKey(key, output_KeyList, output_EnterCounter);
-
     static bool firstTime = true;
     if (firstTime) myOutput = new MyOutputVector();
     firstTime = false;
-    myOutput->push_back(Output(key));
+    myOutput->add(key, Output(key));
 
     sCmd.addCommand(key.c_str(), outputExecute);
 }
@@ -45,11 +42,10 @@ void outputExecute() {
     String key = sCmd.order();
     String value = sCmd.next();
 
-    int number = getKeyNum(key, output_KeyList);
-
     if (myOutput != nullptr) {
-        if (number != -1) {
-            myOutput->at(number).execute(value);
+        Output* item = myOutput->find(key);
+        if (item != nullptr) {
+            item->execute(value);
         }
     }
 }
@@ -14,7 +14,7 @@ PwmOut::PwmOut(unsigned int pin, String key) {
     _pin = pin;
     _key = key;
     pinMode(_pin, OUTPUT);
-    int state = jsonReadInt(configStoreJson, key);
+    int state = storeValues.getInt(key);
     this->execute(String(state));
 }
 PwmOut::~PwmOut() {}
@@ -22,7 +22,7 @@ PwmOut::~PwmOut() {}
 void PwmOut::execute(String state) {
     analogWrite(_pin, state.toInt());
     eventGen2(_key, state);
-    jsonWriteInt(configStoreJson, _key, state.toInt());
+    storeValues.setInt(_key, state.toInt());
     saveStore();
     publishStatus(_key, state);
 }
@@ -35,13 +35,10 @@ void pwmOut() {
     String pin = myLineParsing.gpin();
     myLineParsing.clear();
 
-    pwmOut_EnterCounter++;
-    addKey(key, pwmOut_KeyList, pwmOut_EnterCounter);
-
     static bool firstTime = true;
     if (firstTime) myPwmOut = new MyPwmOutVector();
     firstTime = false;
-    myPwmOut->push_back(PwmOut(pin.toInt(), key));
+    myPwmOut->add(key, PwmOut(pin.toInt(), key));
 
     sCmd.addCommand(key.c_str(), pwmOutExecute);
 }
@@ -50,11 +47,10 @@ void pwmOutExecute() {
     String key = sCmd.order();
     String state = sCmd.next();
 
-    int number = getKeyNum(key, pwmOut_KeyList);
-
     if (myPwmOut != nullptr) {
-        if (number != -1) {
-            myPwmOut->at(number).execute(state);
+        PwmOut* item = myPwmOut->find(key);
+        if (item != nullptr) {
+            item->execute(state);
         }
     }
 }
@@ -1,6 +1,7 @@
 #include "Consts.h"
 #ifdef EnableSensorAnalog
 #include "items/vSensorAnalog.h"
+#include "Class/Deadband.h"
 #include "Class/LineParsing.h"
 #include "Global.h"
 #include "BufferExecute.h"
@@ -21,13 +22,9 @@ SensorAnalog::SensorAnalog(String key, unsigned long interval, unsigned int adcP
 
 SensorAnalog::~SensorAnalog() {}
 
+//период опроса выдерживает itemScheduler
 void SensorAnalog::loop() {
-    currentMillis = millis();
-    difference = currentMillis - prevMillis;
-    if (difference >= _interval) {
-        prevMillis = millis();
-        readAnalog();
-    }
+    readAnalog();
 }
 
 void SensorAnalog::readAnalog() {
@@ -42,9 +39,7 @@ void SensorAnalog::readAnalog() {
     value = map(value, _map1, _map2, _map3, _map4);
     float valueFloat = value * _c;
 
-    eventGen2(_key, String(valueFloat));
-    jsonWriteStr(configLiveJson, _key, String(valueFloat));
-    publishStatus(_key, String(valueFloat));
+    sensorReport(_key, valueFloat);
     SerialPrint("I", "Sensor", "'" + _key + "' data: " + String(valueFloat));
 }
 
@@ -57,6 +52,7 @@ void analogAdc() {
     String key = myLineParsing.gkey();
     String map = myLineParsing.gmap();
     String c = myLineParsing.gc();
+    deadband.add(key, myLineParsing.gdb(), myLineParsing.gminint(), myLineParsing.gmaxint());
     myLineParsing.clear();
 
     int map1 = selectFromMarkerToMarker(map, ",", 0).toInt();
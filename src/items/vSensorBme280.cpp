@@ -5,6 +5,7 @@
 #include <Arduino.h>
 
 #include "BufferExecute.h"
+#include "Class/Deadband.h"
 #include "Class/LineParsing.h"
 #include "Global.h"
 
@@ -27,12 +28,9 @@ SensorBme280::SensorBme280(const paramsBme& paramsTmp, const paramsBme& paramsHu
 
 SensorBme280::~SensorBme280() {}
 
+//период опроса выдерживает itemScheduler
 void SensorBme280::loop() {
-    difference = millis() - prevMillis;
-    if (difference >= _paramsPrs.interval) {
-        prevMillis = millis();
-        read();
-    }
+    read();
 }
 
 void SensorBme280::read() {
@@ -45,19 +43,13 @@ void SensorBme280::read() {
     hum = hum * _paramsHum.c;
     prs = prs * _paramsPrs.c;
 
-    eventGen2(_paramsTmp.key, String(tmp));
-    jsonWriteStr(configLiveJson, _paramsTmp.key, String(tmp));
-    publishStatus(_paramsTmp.key, String(tmp));
+    sensorReport(_paramsTmp.key, tmp);
     SerialPrint("I", "Sensor", "'" + _paramsTmp.key + "' data: " + String(tmp));
 
-    eventGen2(_paramsHum.key, String(hum));
-    jsonWriteStr(configLiveJson, _paramsHum.key, String(hum));
-    publishStatus(_paramsHum.key, String(hum));
+    sensorReport(_paramsHum.key, hum);
     SerialPrint("I", "Sensor", "'" + _paramsHum.key + "' data: " + String(hum));
 
-    eventGen2(_paramsPrs.key, String(prs));
-    jsonWriteStr(configLiveJson, _paramsPrs.key, String(prs));
-    publishStatus(_paramsPrs.key, String(prs));
+    sensorReport(_paramsPrs.key, prs);
     SerialPrint("I", "Sensor", "'" + _paramsPrs.key + "' data: " + String(prs));
 }
 
@@ -69,6 +61,7 @@ void bme280Sensor() {
     String addr = myLineParsing.gaddr();
     String interval = myLineParsing.gint();
     String c = myLineParsing.gc();
+    deadband.add(key, myLineParsing.gdb(), myLineParsing.gminint(), myLineParsing.gmaxint());
     myLineParsing.clear();
 
     static int enterCnt = -1;
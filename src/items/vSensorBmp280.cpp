@@ -5,6 +5,7 @@
 #include <Arduino.h>
 
 #include "BufferExecute.h"
+#include "Class/Deadband.h"
 #include "Class/LineParsing.h"
 #include "Global.h"
 
@@ -25,12 +26,9 @@ SensorBmp280::SensorBmp280(const paramsBmp& paramsTmp, const paramsBmp& paramsPr
 
 SensorBmp280::~SensorBmp280() {}
 
+//период опроса выдерживает itemScheduler
 void SensorBmp280::loop() {
-    difference = millis() - prevMillis;
-    if (difference >= _paramsPrs.interval) {
-        prevMillis = millis();
-        read();
-    }
+    read();
 }
 
 void SensorBmp280::read() {
@@ -41,14 +39,10 @@ void SensorBmp280::read() {
     tmp = tmp * _paramsTmp.c;
     prs = prs * _paramsPrs.c;
 
-    eventGen2(_paramsTmp.key, String(tmp));
-    jsonWriteStr(configLiveJson, _paramsTmp.key, String(tmp));
-    publishStatus(_paramsTmp.key, String(tmp));
+    sensorReport(_paramsTmp.key, tmp);
     SerialPrint("I", "Sensor", "'" + _paramsTmp.key + "' data: " + String(tmp));
 
-    eventGen2(_paramsPrs.key, String(prs));
-    jsonWriteStr(configLiveJson, _paramsPrs.key, String(prs));
-    publishStatus(_paramsPrs.key, String(prs));
+    sensorReport(_paramsPrs.key, prs);
     SerialPrint("I", "Sensor", "'" + _paramsPrs.key + "' data: " + String(prs));
 }
 
@@ -60,6 +54,7 @@ void bmp280Sensor() {
     String addr = myLineParsing.gaddr();
     String interval = myLineParsing.gint();
     String c = myLineParsing.gc();
+    deadband.add(key, myLineParsing.gdb(), myLineParsing.gminint(), myLineParsing.gmaxint());
     myLineParsing.clear();
 
     static int enterCnt = -1;
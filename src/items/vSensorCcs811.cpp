@@ -5,6 +5,7 @@
 #include <Arduino.h>
 
 #include "BufferExecute.h"
+#include "Class/Deadband.h"
 #include "Class/LineParsing.h"
 #include "Global.h"
 
@@ -19,12 +20,9 @@ SensorCcs811::SensorCcs811(const paramsCcs811& paramsPpm, const paramsCcs811& pa
 
 SensorCcs811::~SensorCcs811() {}
 
+//период опроса выдерживает itemScheduler
 void SensorCcs811::loop() {
-    difference = millis() - prevMillis;
-    if (difference >= _paramsPpb.interval) {
-        prevMillis = millis();
-        read();
-    }
+    read();
 }
 
 void SensorCcs811::read() {
@@ -38,14 +36,10 @@ void SensorCcs811::read() {
             co2 = co2 * _paramsPpm.c;
             ppm = ppm * _paramsPpb.c;
 
-            eventGen2(_paramsPpm.key, String(co2));
-            jsonWriteStr(configLiveJson, _paramsPpm.key, String(co2));
-            publishStatus(_paramsPpm.key, String(co2));
+            sensorReport(_paramsPpm.key, co2);
             SerialPrint("I", "Sensor", "'" + _paramsPpm.key + "' data: " + String(co2));
 
-            eventGen2(_paramsPpb.key, String(ppm));
-            jsonWriteStr(configLiveJson, _paramsPpb.key, String(ppm));
-            publishStatus(_paramsPpb.key, String(ppm));
+            sensorReport(_paramsPpb.key, ppm);
             SerialPrint("I", "Sensor", "'" + _paramsPpb.key + "' data: " + String(ppm));
         } else {
             SerialPrint("E", "Sensor CCS", "Error");
@@ -61,6 +55,7 @@ void ccs811Sensor() {
     String addr = myLineParsing.gaddr();
     String interval = myLineParsing.gint();
     String c = myLineParsing.gc();
+    deadband.add(key, myLineParsing.gdb(), myLineParsing.gminint(), myLineParsing.gmaxint());
     myLineParsing.clear();
 
     static int enterCnt = -1;
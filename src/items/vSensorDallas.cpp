@@ -2,6 +2,7 @@
 #ifdef EnableSensorDallas
 #include "items/vSensorDallas.h"
 #include "BufferExecute.h"
+#include "Class/Deadband.h"
 #include "Class/LineParsing.h"
 #include "Global.h"
 
@@ -24,21 +25,15 @@ SensorDallas::SensorDallas(unsigned long interval, unsigned int pin, unsigned in
 
 SensorDallas::~SensorDallas() {}
 
+//период опроса выдерживает itemScheduler
 void SensorDallas::loop() {
-    currentMillis = millis();
-    difference = currentMillis - prevMillis;
-    if (difference >= _interval) {
-        prevMillis = millis();
-        readDallas();
-    }
+    readDallas();
 }
 
 void SensorDallas::readDallas() {
     sensors.requestTemperaturesByIndex(_index);
     float value = sensors.getTempCByIndex(_index);
-    eventGen2(_key, String(value));
-    jsonWriteStr(configLiveJson, _key, String(value));
-    publishStatus(_key, String(value));
+    sensorReport(_key, value);
     SerialPrint("I", "Sensor", "'" + _key + "' data: " + String(value));
 }
 
@@ -50,6 +45,7 @@ void dallas() {
     String pin = myLineParsing.gpin();
     String index = myLineParsing.gindex();
     String key = myLineParsing.gkey();
+    deadband.add(key, myLineParsing.gdb(), myLineParsing.gminint(), myLineParsing.gmaxint());
     myLineParsing.clear();
 
     static bool firstTime = true;
@@ -5,6 +5,7 @@
 #include <Arduino.h>
 
 #include "BufferExecute.h"
+#include "Class/Deadband.h"
 #include "Class/LineParsing.h"
 #include "Global.h"
 
@@ -25,12 +26,9 @@ SensorDht::SensorDht(const paramsDht& paramsTmp, const paramsDht& paramsHum) {
 
 SensorDht::~SensorDht() {}
 
+//период опроса выдерживает itemScheduler
 void SensorDht::loop() {
-    difference = millis() - prevMillis;
-    if (difference >= _paramsHum.interval) {
-        prevMillis = millis();
-        readTmpHum();
-    }
+    readTmpHum();
 }
 
 void SensorDht::readTmpHum() {
@@ -41,14 +39,10 @@ void SensorDht::readTmpHum() {
         tmp = tmp * _paramsTmp.c;
         hum = hum * _paramsHum.c;
 
-        eventGen2(_paramsTmp.key, String(tmp));
-        jsonWriteStr(configLiveJson, _paramsTmp.key, String(tmp));
-        publishStatus(_paramsTmp.key, String(tmp));
+        sensorReport(_paramsTmp.key, tmp);
         SerialPrint("I", "Sensor", "'" + _paramsTmp.key + "' data: " + String(tmp));
 
-        eventGen2(_paramsHum.key, String(hum));
-        jsonWriteStr(configLiveJson, _paramsHum.key, String(hum));
-        publishStatus(_paramsHum.key, String(hum));
+        sensorReport(_paramsHum.key, hum);
         SerialPrint("I", "Sensor", "'" + _paramsHum.key + "' data: " + String(hum));
 
     } else {
@@ -65,6 +59,7 @@ void dhtSensor() {
     String pin = myLineParsing.gpin();
     String key = myLineParsing.gkey();
     String c = myLineParsing.gc();
+    deadband.add(key, myLineParsing.gdb(), myLineParsing.gminint(), myLineParsing.gmaxint());
     myLineParsing.clear();
 
     static int enterCnt = -1;
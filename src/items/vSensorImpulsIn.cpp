@@ -18,7 +18,7 @@
 //    float voltage;  //= (impulsIn->values()->voltage * _paramsV.c) + _paramsV.k;
 //
 //    eventGen2(_paramsImpuls.key, String(voltage));
-//    jsonWriteStr(configLiveJson, _paramsImpuls.key, String(voltage));
+//    liveValues.setFloat(_paramsImpuls.key, voltage);
 //    publishStatus(_paramsImpuls.key, String(voltage));
 //    SerialPrint("I", "Sensor", "'" + _paramsImpuls.key + "' data: " + String(voltage));
 //}
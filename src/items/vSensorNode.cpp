@@ -35,7 +35,7 @@ void SensorNode::onChange(String newValue, String incommingKey) {
         newValue = String(newValue.toFloat() + _params.k);
 
         eventGen2(_params.key, newValue);
-        jsonWriteStr(configLiveJson, _params.key, newValue);
+        liveValues.setStr(_params.key, newValue);
         publishStatus(_params.key, newValue);
 
         _updateTime = timeNow->getDateTimeDotFormated();
@@ -86,12 +86,4 @@ void nodeSensor() {
     firstTime = false;
     mySensorNode->push_back(SensorNode(params));
 }
-
-void publishTimes() {
-    if (mySensorNode != nullptr) {
-        for (unsigned int i = 0; i < mySensorNode->size(); i++) {
-            mySensorNode->at(i).publish();
-        }
-    }
-}
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "items/vSensorPzem.h"
 
 #include "BufferExecute.h"
+#include "Class/Deadband.h"
 #include "Class/LineParsing.h"
 #include "Global.h"
 #include "SoftUART.h"
@@ -19,12 +20,9 @@ SensorPzem::SensorPzem(const paramsPzem& paramsV, const paramsPzem& paramsA, con
 
 SensorPzem::~SensorPzem() {}
 
+//период опроса выдерживает itemScheduler
 void SensorPzem::loop() {
-    difference = millis() - prevMillis;
-    if (difference >= _paramsHz.interval) {
-        prevMillis = millis();
-        read();
-    }
+    read();
 }
 
 void SensorPzem::read() {
@@ -35,29 +33,19 @@ void SensorPzem::read() {
         float energy = (pzem->values()->energy * _paramsWattHrs.c) + _paramsWattHrs.k;
         float freq = (pzem->values()->freq * _paramsHz.c) + _paramsHz.k;
 
-        eventGen2(_paramsV.key, String(voltage));
-        jsonWriteStr(configLiveJson, _paramsV.key, String(voltage));
-        publishStatus(_paramsV.key, String(voltage));
+        sensorReport(_paramsV.key, voltage);
         SerialPrint("I", "Sensor", "'" + _paramsV.key + "' data: " + String(voltage));
 
-        eventGen2(_paramsA.key, String(current));
-        jsonWriteStr(configLiveJson, _paramsA.key, String(current));
-        publishStatus(_paramsA.key, String(current));
+        sensorReport(_paramsA.key, current);
         SerialPrint("I", "Sensor", "'" + _paramsA.key + "' data: " + String(current));
 
-        eventGen2(_paramsWatt.key, String(power));
-        jsonWriteStr(configLiveJson, _paramsWatt.key, String(power));
-        publishStatus(_paramsWatt.key, String(power));
+        sensorReport(_paramsWatt.key, power);
         SerialPrint("I", "Sensor", "'" + _paramsWatt.key + "' data: " + String(power));
 
-        eventGen2(_paramsWattHrs.key, String(energy));
-        jsonWriteStr(configLiveJson, _paramsWattHrs.key, String(energy));
-        publishStatus(_paramsWattHrs.key, String(energy));
+        sensorReport(_paramsWattHrs.key, energy);
         SerialPrint("I", "Sensor", "'" + _paramsWattHrs.key + "' data: " + String(energy));
 
-        eventGen2(_paramsHz.key, String(freq));
-        jsonWriteStr(configLiveJson, _paramsHz.key, String(freq));
-        publishStatus(_paramsHz.key, String(freq));
+        sensorReport(_paramsHz.key, freq);
         SerialPrint("I", "Sensor", "'" + _paramsHz.key + "' data: " + String(freq));
     } else {
         SerialPrint("E", "Sensor PZEM", "Error, UART switched off");
@@ -74,6 +62,7 @@ void pzemSensor() {
         String interval = myLineParsing.gint();
         String c = myLineParsing.gc();
         String k = myLineParsing.gk();
+        deadband.add(key, myLineParsing.gdb(), myLineParsing.gminint(), myLineParsing.gmaxint());
         myLineParsing.clear();
 
         static int enterCnt = -1;
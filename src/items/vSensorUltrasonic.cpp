@@ -5,6 +5,7 @@
 #include <Arduino.h>
 
 #include "BufferExecute.h"
+#include "Class/Deadband.h"
 #include "Class/LineParsing.h"
 #include "Global.h"
 
@@ -29,13 +30,9 @@ SensorUltrasonic::SensorUltrasonic(String key, unsigned long interval, unsigned
 
 SensorUltrasonic::~SensorUltrasonic() {}
 
+//период опроса выдерживает itemScheduler
 void SensorUltrasonic::loop() {
-    currentMillis = millis();
-    difference = currentMillis - prevMillis;
-    if (difference >= _interval) {
-        prevMillis = millis();
-        readUltrasonic();
-    }
+    readUltrasonic();
 }
 
 void SensorUltrasonic::readUltrasonic() {
@@ -58,9 +55,7 @@ void SensorUltrasonic::readUltrasonic() {
     float valueFloat = value * _c;
 
     if (counter > 10) {
-        eventGen2(_key, String(valueFloat));
-        jsonWriteStr(configLiveJson, _key, String(valueFloat));
-        publishStatus(_key, String(valueFloat));
+        sensorReport(_key, valueFloat);
         SerialPrint("I", "Sensor", "'" + _key + "' data: " + String(valueFloat));
     }
 }
@@ -74,6 +69,7 @@ void ultrasonic() {
     String key = myLineParsing.gkey();
     String map = myLineParsing.gmap();
     String c = myLineParsing.gc();
+    deadband.add(key, myLineParsing.gdb(), myLineParsing.gminint(), myLineParsing.gmaxint());
     myLineParsing.clear();
 
     unsigned int trig = selectFromMarkerToMarker(pin, ",", 0).toInt();
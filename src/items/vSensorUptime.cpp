@@ -14,19 +14,16 @@ SensorUptime::SensorUptime(const paramsUptime& paramsUpt) {
 
 SensorUptime::~SensorUptime() {}
 
+//период опроса выдерживает itemScheduler
 void SensorUptime::loop() {
-    difference = millis() - prevMillis;
-    if (difference >= _paramsUpt.interval) {
-        prevMillis = millis();
-        read();
-    }
+    read();
 }
 
 void SensorUptime::read() {
     String upt = timeNow->getUptime();
 
     eventGen2(_paramsUpt.key, upt);
-    jsonWriteStr(configLiveJson, _paramsUpt.key, upt);
+    liveValues.setStr(_paramsUpt.key, upt);
     publishStatus(_paramsUpt.key, upt);
     SerialPrint("I", "Sensor", "'" + _paramsUpt.key + "' data: " + upt);
 }
@@ -4,8 +4,13 @@
 #include "BufferExecute.h"
 #include "Bus.h"
 #include "Class/CallBackTest.h"
+#include "Class/ItemScheduler.h"
+#include "Class/KvStore.h"
+#include "Class/LogQuery.h"
+#include "Class/MqttOutbox.h"
 #include "Class/NotAsync.h"
 #include "Class/ScenarioClass3.h"
+#include "Class/WebSnapshot.h"
 #include "Cmd.h"
 #include "FileSystem.h"
 #include "Global.h"
@@ -20,19 +25,6 @@
 #include "Utils/WebUtils.h"
 #include "MySensorsDataParse.h"
 #include "items/ButtonInClass.h"
-#include "items/vCountDown.h"
-#include "items/vImpulsOut.h"
-#include "items/vLogging.h"
-#include "items/vSensorAnalog.h"
-#include "items/vSensorBme280.h"
-#include "items/vSensorBmp280.h"
-#include "items/vSensorCcs811.h"
-#include "items/vSensorDallas.h"
-#include "items/vSensorDht.h"
-#include "items/vSensorPzem.h"
-#include "items/vSensorUltrasonic.h"
-#include "items/vSensorUptime.h"
-#include "items/vSensorNode.h"
 
 //hap
 #ifdef ENABLE_HAP
@@ -63,6 +55,8 @@ void setup() {
     //=========================================initialisation==============================================================
     setChipId();
     fileSystemInit();
+    kvStore.begin();
+    mqttOutbox.begin();
     loadConfig();
 #ifdef EnableUart
     uartInit();
@@ -113,6 +107,7 @@ void loop() {
     if (!initialized) {
         return;
     }
+    loopStats.begin();
 #ifdef OTA_UPDATES_ENABLED
     ArduinoOTA.handle();
 #endif
@@ -126,6 +121,7 @@ void loop() {
     loopCmdExecute();
 
     myNotAsyncActions->loop();
+    settings.loop();
     ts.update();
 
 #ifdef EnableTelegram
@@ -143,99 +139,15 @@ void loop() {
     loopMySensorsExecute();
 #endif
 
-#ifdef EnableCountDown
-    if (myCountDown != nullptr) {
-        for (unsigned int i = 0; i < myCountDown->size(); i++) {
-            myCountDown->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableImpulsOut
-    if (myImpulsOut != nullptr) {
-        for (unsigned int i = 0; i < myImpulsOut->size(); i++) {
-            myImpulsOut->at(i).loop();
-        }
-    }
-#endif
+    itemScheduler.loop();
+    storeLoop();
+    webSnapshotsLoop();
 #ifdef EnableLogging
-    if (myLogging != nullptr) {
-        for (unsigned int i = 0; i < myLogging->size(); i++) {
-            myLogging->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorDallas
-    if (mySensorDallas2 != nullptr) {
-        for (unsigned int i = 0; i < mySensorDallas2->size(); i++) {
-            mySensorDallas2->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorUltrasonic
-    if (mySensorUltrasonic != nullptr) {
-        for (unsigned int i = 0; i < mySensorUltrasonic->size(); i++) {
-            mySensorUltrasonic->at(i).loop();
-        }
-    }
+    logQueriesLoop();
 #endif
 
-#ifdef EnableSensorAnalog
-    if (mySensorAnalog != nullptr) {
-        for (unsigned int i = 0; i < mySensorAnalog->size(); i++) {
-            mySensorAnalog->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorDht
-    if (mySensorDht != nullptr) {
-        for (unsigned int i = 0; i < mySensorDht->size(); i++) {
-            mySensorDht->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorBme280
-    if (mySensorBme280 != nullptr) {
-        for (unsigned int i = 0; i < mySensorBme280->size(); i++) {
-            mySensorBme280->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorBmp280
-    if (mySensorBmp280 != nullptr) {
-        for (unsigned int i = 0; i < mySensorBmp280->size(); i++) {
-            mySensorBmp280->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorCcs811
-    if (mySensorCcs811 != nullptr) {
-        for (unsigned int i = 0; i < mySensorCcs811->size(); i++) {
-            mySensorCcs811->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorPzem
-    if (mySensorPzem != nullptr) {
-        for (unsigned int i = 0; i < mySensorPzem->size(); i++) {
-            mySensorPzem->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorUptime
-    if (mySensorUptime != nullptr) {
-        for (unsigned int i = 0; i < mySensorUptime->size(); i++) {
-            mySensorUptime->at(i).loop();
-        }
-    }
-#endif
-#ifdef EnableSensorNode
-    if (mySensorNode != nullptr) {
-        for (unsigned int i = 0; i < mySensorNode->size(); i++) {
-            mySensorNode->at(i).loop();
-        }
-    }
-#endif
 #ifdef EnableButtonIn
     myButtonIn.loop();
 #endif
+    loopStats.end();
 }
\ No newline at end of file
@@ -0,0 +1,246 @@
+#pragma once
+/*
+* Ядро Arduino для сборки тестов на компьютере (env:native)
+* String поверх std::string, millis() - управляемые тестом часы, micros() - настоящее время
+*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+//в newlib timezone - структура, в glibc - еще и переменная, Clock.h пишет ее без struct
+struct HostTimezone {
+    int tz_minuteswest;
+    int tz_dsttime;
+};
+#define timezone HostTimezone
+#define gettimeofday(tv, tz) gettimeofday(tv, nullptr)
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class __FlashStringHelper;
+#define F(x) (reinterpret_cast<const __FlashStringHelper*>(x))
+#define PSTR(x) (x)
+#define PROGMEM
+#define HEX 16
+#define DEC 10
+#define OUTPUT 1
+#define INPUT 0
+#define INPUT_PULLUP 2
+#define HIGH 1
+#define LOW 0
+#define A0 0
+
+class String {
+   public:
+    String() {}
+    String(const char* c) : _s(c ? c : "") {}
+    String(const __FlashStringHelper* c) : _s((const char*)c) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(int v, unsigned char base = 10) { format(base == 16 ? "%x" : "%d", v); }
+    explicit String(unsigned int v, unsigned char base = 10) { format(base == 16 ? "%x" : "%u", v); }
+    explicit String(long v, unsigned char base = 10) { format(base == 16 ? "%lx" : "%ld", v); }
+    explicit String(unsigned long v, unsigned char base = 10) { format(base == 16 ? "%lx" : "%lu", v); }
+    explicit String(float v, unsigned char d = 2) { format("%.*f", d, (double)v); }
+    explicit String(double v, unsigned char d = 2) { format("%.*f", d, v); }
+
+    unsigned int length() const { return _s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    const char* c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int n) {
+        _s.reserve(n);
+        return true;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return pos(_s.find(c, from)); }
+    int indexOf(const String& str, unsigned int from = 0) const { return pos(_s.find(str._s, from)); }
+    int lastIndexOf(char c) const { return pos(_s.rfind(c)); }
+    int lastIndexOf(const String& str) const { return pos(_s.rfind(str._s)); }
+    String substring(unsigned int from) const { return substring(from, _s.size()); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from > _s.size()) return String();
+        if (to > _s.size()) to = _s.size();
+        String ret;
+        ret._s = _s.substr(from, to - from);
+        return ret;
+    }
+    void replace(const String& from, const String& to) {
+        if (from._s.empty()) return;
+        for (size_t p = 0; (p = _s.find(from._s, p)) != std::string::npos; p += to._s.size()) {
+            _s.replace(p, from._s.size(), to._s);
+        }
+    }
+    void replace(char from, char to) { std::replace(_s.begin(), _s.end(), from, to); }
+    void remove(unsigned int index) {
+        if (index < _s.size()) _s.erase(index);
+    }
+    void remove(unsigned int index, unsigned int count) {
+        if (index < _s.size()) _s.erase(index, count);
+    }
+    void trim() {
+        size_t a = _s.find_first_not_of(" \t\r\n");
+        size_t b = _s.find_last_not_of(" \t\r\n");
+        _s = a == std::string::npos ? "" : _s.substr(a, b - a + 1);
+    }
+    void toLowerCase() { std::transform(_s.begin(), _s.end(), _s.begin(), ::tolower); }
+    long toInt() const { return atol(_s.c_str()); }
+    float toFloat() const { return atof(_s.c_str()); }
+    bool startsWith(const String& p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+    bool endsWith(const String& p) const { return _s.size() >= p._s.size() && _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0; }
+    char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    char& operator[](unsigned int i) { return _s[i]; }
+    void setCharAt(unsigned int i, char c) {
+        if (i < _s.size()) _s[i] = c;
+    }
+    void toCharArray(char* buf, unsigned int n) const {
+        if (!n) return;
+        strncpy(buf, _s.c_str(), n - 1);
+        buf[n - 1] = 0;
+    }
+    bool concat(const String& o) {
+        _s += o._s;
+        return true;
+    }
+    bool concat(const char* o, unsigned int n) {
+        _s.append(o, n);
+        return true;
+    }
+    bool concat(char c) {
+        _s += c;
+        return true;
+    }
+    String& operator+=(const String& o) {
+        _s += o._s;
+        return *this;
+    }
+    String& operator+=(const char* o) {
+        _s += o;
+        return *this;
+    }
+    String& operator+=(char c) {
+        _s += c;
+        return *this;
+    }
+    String& operator+=(int v) { return *this += String(v); }
+    String& operator+=(unsigned int v) { return *this += String(v); }
+    String& operator+=(long v) { return *this += String(v); }
+    String& operator+=(unsigned long v) { return *this += String(v); }
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator==(const char* o) const { return _s == (o ? o : ""); }
+    bool operator!=(const String& o) const { return _s != o._s; }
+    bool operator!=(const char* o) const { return _s != (o ? o : ""); }
+    bool operator<(const String& o) const { return _s < o._s; }
+    bool equals(const String& o) const { return _s == o._s; }
+    int compareTo(const String& o) const { return _s.compare(o._s); }
+
+   private:
+    template <typename... Args>
+    void format(const char* fmt, Args... args) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), fmt, args...);
+        _s = buf;
+    }
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+
+    std::string _s;
+};
+
+inline String operator+(const String& a, const String& b) {
+    String r(a);
+    r += b;
+    return r;
+}
+inline String operator+(const String& a, const char* b) {
+    String r(a);
+    r += b;
+    return r;
+}
+inline String operator+(const char* a, const String& b) {
+    String r(a);
+    r += b;
+    return r;
+}
+inline String operator+(const String& a, char b) {
+    String r(a);
+    r += b;
+    return r;
+}
+inline String operator+(const String& a, int b) { return a + String(b); }
+inline String operator+(const String& a, unsigned long b) { return a + String(b); }
+inline String operator+(const String& a, const __FlashStringHelper* b) { return a + String(b); }
+
+class Print {
+   public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) { return 1; }
+    virtual size_t write(const uint8_t*, size_t n) { return n; }
+    size_t write(const char* b, size_t n) { return write((const uint8_t*)b, n); }
+    size_t write(const char* b) { return write((const uint8_t*)b, strlen(b)); }
+    template <typename T>
+    size_t print(const T&) { return 0; }
+    template <typename T>
+    size_t println(const T&) { return 0; }
+    size_t println() { return 0; }
+    void flush() {}
+};
+
+class Stream : public Print {
+   public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    void setTimeout(unsigned long) {}
+};
+
+class HardwareSerial : public Stream {
+   public:
+    void begin(unsigned long) {}
+};
+static HardwareSerial Serial;
+
+//время millis() двигает сам тест
+inline unsigned long& hostMillis() {
+    static unsigned long now = 0;
+    return now;
+}
+inline unsigned long millis() { return hostMillis(); }
+inline unsigned long micros() {
+    static auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+inline void delay(unsigned long ms) { hostMillis() += ms; }
+inline void yield() {}
+inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = 0;
+    }
+    return len;
+}
+inline void configTime(long, int, const char*, const char*, const char*) {}
+inline long random(long max) { return max > 0 ? rand() % max : 0; }
+inline long random(long min, long max) { return max > min ? min + rand() % (max - min) : min; }
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) { return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin; }
+inline char* dtostrf(double v, signed char width, unsigned char prec, char* buf) {
+    sprintf(buf, "%*.*f", width, prec, v);
+    return buf;
+}
+
+//на ESP32/ESP8266 объявлены в заголовках платформы, которые для компьютера не подключаются
+class AsyncWebServer;
+class AsyncWebSocket;
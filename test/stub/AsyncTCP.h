@@ -0,0 +1,47 @@
+#pragma once
+#include <Arduino.h>
+
+#include "PubSubClient.h"
+
+/*
+* Асинхронный TCP клиент-заглушка: к доступному брокеру (reachable) onConnect вызывается
+* прямо из connect(), к недоступному ответа нет вовсе, как у пакетов, ушедших в никуда
+*/
+class AsyncClient {
+   public:
+    typedef std::function<void(void*, AsyncClient*)> AcConnectHandler;
+    typedef std::function<void(void*, AsyncClient*, int8_t)> AcErrorHandler;
+
+    void onConnect(AcConnectHandler cb, void* arg = nullptr) {
+        _connectCb = cb;
+        _connectArg = arg;
+    }
+    void onError(AcErrorHandler cb, void* arg = nullptr) {
+        _errorCb = cb;
+        _errorArg = arg;
+    }
+    bool connect(IPAddress, uint16_t) { return start(); }
+    bool connect(const char*, uint16_t) { return start(); }
+    void close(bool = false) {}
+    IPAddress remoteIP() { return IPAddress(0x0100007f); }
+
+    static bool reachable;
+    static size_t attempts;
+
+   private:
+    bool start() {
+        attempts++;
+        if (reachable && _connectCb) {
+            _connectCb(_connectArg, this);
+        }
+        return true;
+    }
+
+    AcConnectHandler _connectCb;
+    AcErrorHandler _errorCb;
+    void* _connectArg = nullptr;
+    void* _errorArg = nullptr;
+};
+
+bool AsyncClient::reachable = true;
+size_t AsyncClient::attempts = 0;
@@ -0,0 +1,172 @@
+#pragma once
+#include <Arduino.h>
+
+#include <map>
+#include <string>
+
+/*
+* Файловая система в памяти для тестов
+* writeBudget - сколько байт еще запишется до "отключения питания": дальше запись обрывается
+* (по умолчанию без ограничения), totalBytes - размер для FileFS.info()/totalBytes()
+*/
+struct HostFiles {
+    std::map<std::string, std::string> files;
+    long writeBudget = -1;
+    size_t totalBytes = 1024 * 1024;
+
+    void reset() {
+        files.clear();
+        writeBudget = -1;
+    }
+};
+
+inline HostFiles& hostFiles() {
+    static HostFiles fs;
+    return fs;
+}
+
+enum SeekMode {
+    SeekSet,
+    SeekCur,
+    SeekEnd
+};
+
+struct FSInfo {
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+class File : public Stream {
+   public:
+    File() {}
+    File(const std::string& path, const char* mode) : _path(path), _ok(true) {
+        std::map<std::string, std::string>& files = hostFiles().files;
+        if (mode[0] == 'w') {
+            files[path].clear();
+        } else if (mode[0] == 'a') {
+            _pos = files[path].size();
+        } else if (!files.count(path)) {
+            _ok = false;
+        }
+    }
+
+    operator bool() const { return _ok; }
+    size_t size() const { return data().size(); }
+    size_t position() const { return _pos; }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+        if (mode == SeekCur) {
+            pos += _pos;
+        } else if (mode == SeekEnd) {
+            pos += size();
+        }
+        if (pos > size()) {
+            return false;
+        }
+        _pos = pos;
+        return true;
+    }
+    void close() { _ok = false; }
+    void flush() {}
+    const char* name() const { return _path.c_str(); }
+
+    int available() override { return _ok ? size() - _pos : 0; }
+    int read() override { return _pos < size() ? (uint8_t)data()[_pos++] : -1; }
+    int peek() override { return _pos < size() ? (uint8_t)data()[_pos] : -1; }
+    size_t read(uint8_t* buf, size_t len) {
+        size_t n = 0;
+        while (n < len && _pos < size()) {
+            buf[n++] = data()[_pos++];
+        }
+        return n;
+    }
+    String readStringUntil(char terminator) {
+        String ret;
+        int c;
+        while ((c = read()) >= 0 && c != terminator) {
+            ret += (char)c;
+        }
+        return ret;
+    }
+    String readString() { return readStringUntil('\0'); }
+    bool find(const char* target) {
+        size_t p = data().find(target, _pos);
+        if (p == std::string::npos) {
+            _pos = size();
+            return false;
+        }
+        _pos = p + strlen(target);
+        return true;
+    }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t len) override {
+        if (!_ok) {
+            return 0;
+        }
+        long& budget = hostFiles().writeBudget;
+        if (budget >= 0 && (long)len > budget) {
+            len = budget;
+        }
+        if (budget >= 0) {
+            budget -= len;
+        }
+        std::string& f = hostFiles().files[_path];
+        if (f.size() < _pos + len) {
+            f.resize(_pos + len);
+        }
+        f.replace(_pos, len, (const char*)buf, len);
+        _pos += len;
+        return len;
+    }
+    using Print::write;
+    size_t print(const String& str) { return write((const uint8_t*)str.c_str(), str.length()); }
+    size_t println(const String& str) { return print(str) + write((const uint8_t*)"\r\n", 2); }
+
+   private:
+    const std::string& data() const { return hostFiles().files[_path]; }
+
+    std::string _path;
+    bool _ok = false;
+    size_t _pos = 0;
+};
+
+class FS {
+   public:
+    bool begin() { return true; }
+    File open(const String& path, const char* mode = "r") { return File(path.c_str(), mode); }
+    File open(const char* path, const char* mode = "r") { return File(path, mode); }
+    bool exists(const String& path) { return hostFiles().files.count(path.c_str()); }
+    bool remove(const String& path) { return hostFiles().files.erase(path.c_str()); }
+    bool rename(const String& from, const String& to) {
+        std::map<std::string, std::string>& files = hostFiles().files;
+        if (!files.count(from.c_str()) || files.count(to.c_str())) {
+            return false;
+        }
+        files[to.c_str()] = files[from.c_str()];
+        files.erase(from.c_str());
+        return true;
+    }
+    bool mkdir(const String&) { return true; }
+    size_t totalBytes() { return hostFiles().totalBytes; }
+    size_t usedBytes() {
+        size_t used = 0;
+        for (auto& f : hostFiles().files) {
+            used += f.second.size();
+        }
+        return used;
+    }
+    bool info(FSInfo& info) {
+        memset(&info, 0, sizeof(info));
+        info.totalBytes = totalBytes();
+        info.usedBytes = usedBytes();
+        return true;
+    }
+};
+
+static FS HostFS;
+#define FileFS HostFS
+#define FS_NAME "HostFS"
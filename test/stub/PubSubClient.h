@@ -0,0 +1,114 @@
+#pragma once
+#include <Arduino.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+class WiFiClient : public Stream {
+   public:
+    void setTimeout(unsigned long) {}
+};
+
+class IPAddress {
+   public:
+    IPAddress() {}
+    explicit IPAddress(uint32_t addr) : _addr{addr} {}
+    operator uint32_t() const { return _addr; }
+
+   private:
+    uint32_t _addr = 0;
+};
+
+#define WL_CONNECTED 3
+
+//сеть считается поднятой, адрес брокера всегда находится
+class HostWiFi {
+   public:
+    int status() { return WL_CONNECTED; }
+    bool hostByName(const char*, IPAddress&) { return true; }
+};
+
+static HostWiFi WiFi;
+
+/*
+* Брокер-заглушка: подключение включает и выключает тест (online),
+* опубликованные сообщения складываются в sent, при record = false только считаются без выделения памяти,
+* connect() подключает, если брокер принимает подключения (accepts), иначе ждет stallMs настоящего
+* времени, как connect() по таймауту TCP
+*/
+class PubSubClient {
+   public:
+    struct Message {
+        std::string topic;
+        std::string payload;
+        bool retain;
+    };
+
+    PubSubClient() {}
+    explicit PubSubClient(WiFiClient&) {}
+
+    bool connected() { return online; }
+    bool connect(const char*, const char* = nullptr, const char* = nullptr) {
+        connects++;
+        if (accepts) {
+            online = true;
+        } else if (stallMs) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(stallMs));
+        }
+        return online;
+    }
+    void disconnect() { online = false; }
+    bool loop() { return online; }
+    int state() { return online ? 0 : -1; }
+    bool subscribe(const char*) { return online; }
+    template <typename... Args>
+    PubSubClient& setServer(Args...) { return *this; }
+    template <typename T>
+    PubSubClient& setCallback(T) { return *this; }
+    void setSocketTimeout(uint16_t) {}
+
+    bool beginPublish(const char* topic, unsigned int length, bool retain) {
+        if (!online) {
+            return false;
+        }
+        if (record) {
+            _current.topic = topic;
+            _current.payload.clear();
+            _current.retain = retain;
+        }
+        _declared = length;
+        _written = 0;
+        return true;
+    }
+    size_t write(const uint8_t* data, size_t length) {
+        if (record) {
+            _current.payload.append((const char*)data, length);
+        }
+        _written += length;
+        return length;
+    }
+    int endPublish() {
+        if (_written != _declared) {
+            return 0;
+        }
+        published++;
+        if (record) {
+            sent.push_back(_current);
+        }
+        return 1;
+    }
+
+    bool online = false;
+    bool record = true;
+    bool accepts = false;
+    unsigned long stallMs = 0;
+    size_t connects = 0;
+    size_t published = 0;
+    std::vector<Message> sent;
+
+   private:
+    Message _current;
+    size_t _declared = 0;
+    size_t _written = 0;
+};
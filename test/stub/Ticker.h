@@ -0,0 +1,10 @@
+#pragma once
+#include <Arduino.h>
+
+//TickerScheduler на компьютере не запускается, нужен только тип
+class Ticker {
+   public:
+    template <typename... Args>
+    void attach_ms(Args...) {}
+    void detach() {}
+};
@@ -0,0 +1,205 @@
+/*
+* Сжатый лог: точки после кольца блоков и переоткрытия читаются побитно теми же,
+* испорченный текущий блок отбрасывается без потери заполненных блоков
+* Степень сжатия на логах с устройства: скопировать папку /logs с устройства
+* (.bin - несжатый RingLog, .txt - старый текстовый лог) и указать ее в LOG_TRACES
+* LOG_TRACES=/path/to/logs pio test -e native -f test_block_log
+*/
+#include <unity.h>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../src/Class/BlockLog.cpp"
+#include "../../src/Class/Gorilla.cpp"
+#include "../../src/Class/RingLog.cpp"
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+
+void removeFile(const String& filename) {
+    FileFS.remove(filename);
+}
+
+static uint32_t seed;
+
+static uint32_t nextRandom() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+//датчик: период с дрожанием, значение с шагом 0.1, изредка случайные биты
+static void makePoint(uint32_t i, uint32_t& time, float& value) {
+    static uint32_t t;
+    if (i == 0) {
+        t = 1600000000;
+    }
+    t += 60 + (nextRandom() % 5 == 0 ? nextRandom() % 7 : 0);
+    time = t;
+    if (i % 97 == 0) {
+        uint32_t bits = nextRandom() | (nextRandom() << 24);
+        memcpy(&value, &bits, sizeof(value));
+        if (value != value) {
+            value = 0;  //NaN не сравнить
+        }
+    } else {
+        value = (int)(200 + 50 * sin(i / 100.0)) / 10.0f;
+    }
+}
+
+struct Point {
+    uint32_t time;
+    float value;
+};
+
+static std::vector<Point> readAll(BlockLog& log) {
+    std::vector<Point> points;
+    log.forEach([&points](const RingLogRecord& rec) {
+        points.push_back({rec.time, rec.value});
+    });
+    return points;
+}
+
+static void assertSuffix(const std::vector<Point>& written, const std::vector<Point>& read) {
+    TEST_ASSERT_TRUE(read.size() <= written.size());
+    size_t offset = written.size() - read.size();
+    for (size_t i = 0; i < read.size(); i++) {
+        TEST_ASSERT_EQUAL(written[offset + i].time, read[i].time);
+        TEST_ASSERT_TRUE(memcmp(&written[offset + i].value, &read[i].value, sizeof(float)) == 0);
+    }
+}
+
+void setUp(void) {
+    hostFiles().reset();
+    seed = 1;
+}
+
+void tearDown(void) {}
+
+void test_round_trip_through_ring(void) {
+    std::vector<Point> written;
+    {
+        BlockLog log("/logs/t.gor", 200);
+        for (uint32_t i = 0; i < 5000; i++) {
+            Point p;
+            makePoint(i, p.time, p.value);
+            TEST_ASSERT_TRUE(log.append(p.time, p.value));
+            written.push_back(p);
+        }
+        std::vector<Point> read = readAll(log);
+        TEST_ASSERT_EQUAL(log.count(), read.size());
+        TEST_ASSERT_GREATER_THAN(200, read.size());
+        assertSuffix(written, read);
+        TEST_ASSERT_EQUAL(read[0].time, log.oldestTime());
+    }
+    BlockLog reopened("/logs/t.gor", 200);
+    std::vector<Point> read = readAll(reopened);
+    TEST_ASSERT_EQUAL(reopened.count(), read.size());
+    assertSuffix(written, read);
+}
+
+void test_broken_head_block_dropped(void) {
+    std::vector<Point> written;
+    size_t before;
+    {
+        BlockLog log("/logs/t.gor", 1000);
+        for (uint32_t i = 0; i < 600; i++) {
+            Point p;
+            makePoint(i, p.time, p.value);
+            log.append(p.time, p.value);
+            written.push_back(p);
+        }
+        before = log.count();
+    }
+    std::string& file = hostFiles().files["/logs/t.gor"];
+    BlockLogHeader hdr;
+    memcpy(&hdr, file.data(), sizeof(hdr));
+    TEST_ASSERT_GREATER_THAN(2, hdr.used);
+    size_t head = sizeof(hdr) + hdr.head * LOG_BLOCK_SIZE;
+    uint16_t headCount = (uint8_t)file[head + 8] | ((uint8_t)file[head + 9] << 8);
+    file[head + 8] = (char)0xFF;  //счетчик больше, чем точек в блоке - как после оборванной записи
+    file[head + 9] = (char)0xFF;
+
+    BlockLog log("/logs/t.gor", 1000);
+    TEST_ASSERT_EQUAL(before - headCount, log.count());
+    std::vector<Point> read = readAll(log);
+    TEST_ASSERT_EQUAL(log.count(), read.size());
+    written.resize(written.size() - headCount);
+    assertSuffix(written, read);
+
+    TEST_ASSERT_TRUE(log.append(2000000000, 1.5f));
+    TEST_ASSERT_EQUAL(before - headCount + 1, log.count());
+}
+
+//логи с устройства: сколько байт на точку против 8 байт несжатого RingLog
+void test_compression_on_device_logs(void) {
+    const char* dir = getenv("LOG_TRACES");
+    DIR* d = dir ? opendir(dir) : nullptr;
+    if (!d) {
+        TEST_IGNORE_MESSAGE("LOG_TRACES is not set: no device logs to measure");
+    }
+    size_t files = 0;
+    struct dirent* entry;
+    while ((entry = readdir(d))) {
+        String name = entry->d_name;
+        bool bin = name.endsWith(".bin");
+        if (!bin && !name.endsWith(".txt")) {
+            continue;
+        }
+        FILE* f = fopen((String(dir) + "/" + name).c_str(), "rb");
+        if (!f) {
+            continue;
+        }
+        hostFiles().reset();
+        std::string& data = hostFiles().files["/src"];
+        char buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+            data.append(buf, n);
+        }
+        fclose(f);
+
+        size_t points = 0;
+        if (bin) {
+            RingLogHeader hdr;
+            if (data.size() < sizeof(hdr)) {
+                continue;
+            }
+            memcpy(&hdr, data.data(), sizeof(hdr));
+            if (hdr.magic != RING_LOG_MAGIC || hdr.recordSize != sizeof(RingLogRecord)) {
+                continue;
+            }
+            RingLog ring("/src", hdr.capacity);
+            BlockLog log("/dst", ring.count());
+            ring.forEach([&log](const RingLogRecord& rec) {
+                log.append(rec.time, rec.value);
+            });
+            points = log.count();
+        } else {
+            BlockLog log("/dst", 65535);
+            log.importText("/src");
+            points = log.count();
+        }
+        if (!points) {
+            continue;
+        }
+        size_t size = hostFiles().files["/dst"].size();
+        char msg[160];
+        snprintf(msg, sizeof(msg), "%s: %u points, %.2f bytes/point, ratio %.1fx",
+                 name.c_str(), (unsigned)points, (double)size / points, (double)points * sizeof(RingLogRecord) / size);
+        TEST_MESSAGE(msg);
+        files++;
+    }
+    closedir(d);
+    if (!files) {
+        TEST_IGNORE_MESSAGE("no .bin or .txt logs in LOG_TRACES");
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_through_ring);
+    RUN_TEST(test_broken_head_block_dropped);
+    RUN_TEST(test_compression_on_device_logs);
+    return UNITY_END();
+}
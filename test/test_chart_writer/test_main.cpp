@@ -0,0 +1,128 @@
+/*
+* Отправка графика из лога на 1000 точек пачками ChartWriter: скорость в точках в секунду
+* и пиковый прирост кучи за время отправки (куча считается через operator new)
+* pio test -e native -f test_chart_writer
+*/
+#include <unity.h>
+
+#include <new>
+
+#include "../../src/Class/BlockLog.cpp"
+#include "../../src/Class/ChartWriter.cpp"
+#include "../../src/Class/Gorilla.cpp"
+#include "../../src/Class/RingLog.cpp"
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+
+void removeFile(const String& filename) {
+    FileFS.remove(filename);
+}
+
+//учет кучи: перед каждым блоком хранится его размер
+#define HEAP_HEADER 16  //сохраняет выравнивание блока
+static size_t heapUsed = 0;
+static size_t heapPeak = 0;
+
+void* operator new(size_t size) {
+    size_t* p = (size_t*)malloc(size + HEAP_HEADER);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    *p = size;
+    heapUsed += size;
+    if (heapUsed > heapPeak) {
+        heapPeak = heapUsed;
+    }
+    return (char*)p + HEAP_HEADER;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        size_t* p = (size_t*)((char*)ptr - HEAP_HEADER);
+        heapUsed -= *p;
+        free(p);
+    }
+}
+
+static const size_t POINTS = 1000;
+
+struct Sent {
+    size_t chunks = 0;
+    size_t bytes = 0;
+    size_t points = 0;
+    bool valid = true;
+};
+
+static ChartFlush_t counter(Sent& sent) {
+    return [&sent](const char* data, size_t length) {
+        if (length < 13 || memcmp(data, "{\"status\":[", 11) || memcmp(data + length - 2, "]}", 2)) {
+            sent.valid = false;
+        }
+        for (size_t i = 0; i + 3 <= length; i++) {
+            if (!memcmp(data + i, "\"x\"", 3)) {
+                sent.points++;
+            }
+        }
+        sent.chunks++;
+        sent.bytes += length;
+    };
+}
+
+template <typename Log>
+static void streamLog(Log& log, const char* name) {
+    const int RUNS = 20;
+    Sent sent;
+    ChartFlush_t flush = counter(sent);
+    size_t before = heapUsed;
+    heapPeak = heapUsed;
+    unsigned long start = micros();
+    for (int run = 0; run < RUNS; run++) {
+        ChartWriter writer(100, flush);
+        log.forEach([&writer](const RingLogRecord& rec) {
+            writer.add(rec.time, rec.value);
+        });
+        writer.finish();
+    }
+    unsigned long elapsed = micros() - start;
+    size_t peak = heapPeak - before;
+
+    TEST_ASSERT_TRUE(sent.valid);
+    TEST_ASSERT_EQUAL(POINTS * RUNS, sent.points);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%s: %.0f points/s, %u chunks of %u bytes avg, peak heap +%u bytes",
+             name, (double)POINTS * RUNS * 1000000 / (elapsed ? elapsed : 1), (unsigned)(sent.chunks / RUNS),
+             (unsigned)(sent.bytes / sent.chunks), (unsigned)peak);
+    TEST_MESSAGE(msg);
+    //пачка держится в буфере писателя, куча не растет с числом точек
+    TEST_ASSERT_LESS_THAN(POINTS * sizeof(RingLogRecord), peak);
+}
+
+void setUp(void) {
+    hostFiles().reset();
+}
+
+void tearDown(void) {}
+
+void test_stream_ring_log(void) {
+    RingLog log("/logs/t.bin", POINTS);
+    for (uint32_t i = 0; i < POINTS; i++) {
+        log.append(1600000000 + i * 60, 20 + (i % 50) / 10.0f);
+    }
+    streamLog(log, "RingLog");
+}
+
+void test_stream_block_log(void) {
+    BlockLog log("/logs/t.blg", POINTS);
+    for (uint32_t i = 0; i < POINTS; i++) {
+        log.append(1600000000 + i * 60, 20 + (i % 50) / 10.0f);
+    }
+    TEST_ASSERT_EQUAL(POINTS, log.count());
+    streamLog(log, "BlockLog");
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_stream_ring_log);
+    RUN_TEST(test_stream_block_log);
+    return UNITY_END();
+}
@@ -0,0 +1,172 @@
+/*
+* Очередь событий и команд под нагрузкой: несколько потоков пишут, один читает
+* Записи любой длины доходят целиком, команды не теряются молча
+* pio test -e native -f test_event_queue
+*/
+#include <unity.h>
+
+#include <thread>
+
+#include "../../src/Class/EventQueue.cpp"
+#include "../../src/Class/KeyTable.cpp"
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+
+static String makeValue(int producer, int seq) {
+    String value = String(producer) + ":" + String(seq) + ":";
+    for (int i = 0; i < (seq * 7 + producer) % 300; i++) {
+        value += (char)('a' + (i + seq) % 26);
+    }
+    return value;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_long_payload_intact(void) {
+    EventQueue queue(4, QD_NEWEST);
+    String key;
+    String value;
+    for (int i = 0; i < 100; i++) {
+        key += (char)('a' + i % 26);
+    }
+    for (int i = 0; i < 1000; i++) {
+        value += (char)('0' + i % 10);
+    }
+    TEST_ASSERT_TRUE(queue.push(key, value, ES_WEB));
+    QueueRecord rec;
+    TEST_ASSERT_TRUE(queue.pop(rec));
+    TEST_ASSERT_EQUAL_STRING(key.c_str(), rec.key.c_str());
+    TEST_ASSERT_EQUAL_STRING(value.c_str(), rec.value.c_str());
+    TEST_ASSERT_EQUAL(ES_WEB, rec.source);
+}
+
+void test_order_list_reports_lost(void) {
+    EventQueue queue(4, QD_NEWEST);
+    size_t lost = 0;
+    size_t added = queue.pushList("rel1 1,rel2 0,rel3 1,rel4 1,rel5 0,rel6 1,", ES_WEB, &lost);
+    TEST_ASSERT_EQUAL(4, added);
+    TEST_ASSERT_EQUAL(2, lost);
+    QueueRecord rec;
+    TEST_ASSERT_TRUE(queue.pop(rec));
+    TEST_ASSERT_EQUAL_STRING("rel1", rec.key.c_str());
+    TEST_ASSERT_EQUAL_STRING("1", rec.value.c_str());
+}
+
+//команды: отправитель повторяет отклоненное, до читателя доходит все и по порядку каждого отправителя
+void test_stress_orders_no_loss(void) {
+    const int PRODUCERS = 4;
+    const int RECORDS = 20000;
+    EventQueue queue(32, QD_NEWEST);
+    volatile bool done[PRODUCERS] = {};
+    uint32_t rejected[PRODUCERS] = {};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.push_back(std::thread([&, p]() {
+            for (int seq = 0; seq < RECORDS; seq++) {
+                String key = "order" + String(p);
+                String value = makeValue(p, seq);
+                while (!queue.push(key, value, ES_MQTT)) {
+                    rejected[p]++;
+                    std::this_thread::yield();
+                }
+            }
+            done[p] = true;
+        }));
+    }
+
+    int next[PRODUCERS] = {};
+    int received = 0;
+    bool intact = true;
+    QueueRecord rec;
+    while (received < PRODUCERS * RECORDS) {
+        if (!queue.pop(rec)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int p = rec.key.substring(5).toInt();
+        if (rec.value != makeValue(p, next[p])) {
+            intact = false;
+        }
+        next[p]++;
+        received++;
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    uint32_t rejectedTotal = 0;
+    for (int p = 0; p < PRODUCERS; p++) {
+        TEST_ASSERT_EQUAL(RECORDS, next[p]);
+        rejectedTotal += rejected[p];
+    }
+    TEST_ASSERT_TRUE(intact);
+    TEST_ASSERT_TRUE(queue.empty());
+    TEST_ASSERT_EQUAL(PRODUCERS * RECORDS, queue.stats._pushed);
+    TEST_ASSERT_EQUAL(rejectedTotal, queue.stats._dropped);
+    char msg[128];
+    snprintf(msg, sizeof(msg), "orders: %d delivered, %u rejected and retried, max depth %u",
+             received, (unsigned)rejectedTotal, (unsigned)queue.stats._maxDepth);
+    TEST_MESSAGE(msg);
+}
+
+//события: старое вытесняется, но каждая запись либо разобрана целиком, либо учтена в _dropped
+void test_stress_events_accounted(void) {
+    const int PRODUCERS = 4;
+    const int RECORDS = 20000;
+    EventQueue queue(16, QD_OLDEST);
+    volatile int running = PRODUCERS;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.push_back(std::thread([&, p]() {
+            for (int seq = 0; seq < RECORDS; seq++) {
+                queue.push("event" + String(p), makeValue(p, seq), ES_UDP);
+            }
+            __atomic_fetch_sub(&running, 1, __ATOMIC_RELEASE);
+        }));
+    }
+
+    uint32_t received = 0;
+    int last[PRODUCERS] = {-1, -1, -1, -1};
+    bool ordered = true;
+    bool intact = true;
+    QueueRecord rec;
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE) || !queue.empty()) {
+        if (!queue.pop(rec)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int p = rec.key.substring(5).toInt();
+        int seq = rec.value.substring(rec.value.indexOf(':') + 1).toInt();
+        if (rec.value != makeValue(p, seq)) {
+            intact = false;
+        }
+        if (seq <= last[p]) {
+            ordered = false;
+        }
+        last[p] = seq;
+        received++;
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    TEST_ASSERT_TRUE(intact);
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL(PRODUCERS * RECORDS, received + queue.stats._dropped);
+    char msg[128];
+    snprintf(msg, sizeof(msg), "events: %u delivered, %u dropped", (unsigned)received, (unsigned)queue.stats._dropped);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_long_payload_intact);
+    RUN_TEST(test_order_list_reports_lost);
+    RUN_TEST(test_stress_orders_no_loss);
+    RUN_TEST(test_stress_events_accounted);
+    return UNITY_END();
+}
@@ -0,0 +1,94 @@
+/*
+* Планировщик элементов: элементы в векторе переживают перекладывание при push_back,
+* первые запуски элементов с одинаковым интервалом разнесены
+* pio test -e native -f test_item_scheduler
+*/
+#include <unity.h>
+
+#include "../../src/Class/ItemScheduler.cpp"
+
+class FakeItem : public Item {
+   public:
+    FakeItem(const String& key, unsigned long interval) : _key(key), _interval(interval) {}
+
+    void loop() {
+        runs++;
+        lastRun = millis();
+    }
+
+    unsigned long interval() const {
+        return _interval;
+    }
+
+    const String& itemKey() const {
+        return _key;
+    }
+
+    uint32_t runs = 0;
+    unsigned long lastRun = 0;
+
+   private:
+    String _key;
+    unsigned long _interval;
+};
+
+static void advance(unsigned long ms) {
+    for (unsigned long i = 0; i < ms; i++) {
+        hostMillis()++;
+        itemScheduler.loop();
+    }
+}
+
+void setUp(void) {
+    itemScheduler.clear();
+}
+
+void tearDown(void) {}
+
+void test_items_survive_reallocation(void) {
+    static std::vector<FakeItem> items;
+    items.push_back(FakeItem("first", 1000));
+    itemScheduler.watch(&items);
+    for (int i = 1; i < 100; i++) {
+        items.push_back(FakeItem("item" + String(i), 1000));  //перекладывает вектор
+    }
+    advance(2000);
+    for (size_t i = 0; i < items.size(); i++) {
+        TEST_ASSERT_GREATER_OR_EQUAL(2, items[i].runs);
+    }
+}
+
+void test_first_runs_staggered(void) {
+    static std::vector<FakeItem> items;
+    for (int i = 0; i < 10; i++) {
+        items.push_back(FakeItem("sensor" + String(i), 5000));
+    }
+    itemScheduler.watch(&items);
+    advance(5000);
+    for (size_t i = 1; i < items.size(); i++) {
+        TEST_ASSERT_EQUAL(1, items[i].runs);
+        TEST_ASSERT_TRUE(items[i].lastRun != items[i - 1].lastRun);
+    }
+}
+
+void test_cleared_vector_dropped(void) {
+    static std::vector<FakeItem> items;
+    itemScheduler.watch(&items);
+    items.push_back(FakeItem("a", 10));
+    items.push_back(FakeItem("b", 0));
+    advance(100);
+    TEST_ASSERT_GREATER_THAN(0, items[1].runs);
+    items.clear();
+    advance(100);  //элементов больше нет, обращения к ним быть не должно
+    items.push_back(FakeItem("c", 10));
+    advance(100);
+    TEST_ASSERT_GREATER_THAN(0, items[0].runs);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_items_survive_reallocation);
+    RUN_TEST(test_first_runs_staggered);
+    RUN_TEST(test_cleared_vector_dropped);
+    return UNITY_END();
+}
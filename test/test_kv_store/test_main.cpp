@@ -0,0 +1,157 @@
+/*
+* Хранилище счетчиков: недописанная запись (кончилось место, ошибка ФС) не оставляет
+* мусор в журнале, set() сообщает об ошибке, следующие записи и перезагрузка не теряют данные
+* Время старта и increment() на журнале перед компактированием и после него
+* pio test -e native -f test_kv_store
+*/
+#include <unity.h>
+
+#include "../../src/Class/KvStore.cpp"
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+
+const String readFile(const String& filename, size_t max_size) {
+    return "";
+}
+
+void removeFile(const String& filename) {}
+
+static KvStore* reload() {
+    KvStore* store = new KvStore();
+    store->begin();
+    return store;
+}
+
+void setUp(void) {
+    hostFiles().reset();
+}
+
+void tearDown(void) {}
+
+void test_short_write_reported_and_recovered(void) {
+    KvStore store;
+    store.begin();
+    TEST_ASSERT_TRUE(store.set("count", "1"));
+    TEST_ASSERT_TRUE(store.set("name", "boiler"));
+
+    hostFiles().writeBudget = 5;  //запись обрывается посреди заголовка
+    TEST_ASSERT_FALSE(store.set("count", "2"));
+    TEST_ASSERT_EQUAL_STRING("1", store.get("count").c_str());
+
+    hostFiles().writeBudget = -1;
+    TEST_ASSERT_TRUE(store.set("count", "3"));
+    TEST_ASSERT_TRUE(store.set("state", "on"));
+    TEST_ASSERT_TRUE(store.remove("name"));
+
+    KvStore* loaded = reload();
+    TEST_ASSERT_EQUAL_STRING("3", loaded->get("count").c_str());
+    TEST_ASSERT_EQUAL_STRING("on", loaded->get("state").c_str());
+    TEST_ASSERT_FALSE(loaded->has("name"));
+    delete loaded;
+}
+
+void test_full_fs_keeps_old_log(void) {
+    KvStore store;
+    store.begin();
+    TEST_ASSERT_TRUE(store.set("count", "1"));
+    std::string before = hostFiles().files[KV_STORE_FILE];
+
+    hostFiles().writeBudget = 0;
+    TEST_ASSERT_FALSE(store.set("count", "2"));
+    TEST_ASSERT_FALSE(store.remove("count"));
+    TEST_ASSERT_FALSE(store.set("other", "x"));
+    TEST_ASSERT_TRUE(before == hostFiles().files[KV_STORE_FILE]);
+    TEST_ASSERT_FALSE(FileFS.exists(KV_TMP_FILE));
+
+    hostFiles().writeBudget = -1;
+    TEST_ASSERT_TRUE(store.set("count", "4"));
+    KvStore* loaded = reload();
+    TEST_ASSERT_EQUAL_STRING("4", loaded->get("count").c_str());
+    TEST_ASSERT_FALSE(loaded->has("other"));
+    delete loaded;
+}
+
+static String counterName(int i) {
+    return "counter" + String(i);
+}
+
+//среднее время старта по журналу, который сейчас лежит в ФС
+static double bootMu(int keys, int& wrong) {
+    const int BOOTS = 50;
+    unsigned long start = micros();
+    for (int i = 0; i < BOOTS; i++) {
+        KvStore* loaded = reload();
+        if (loaded->getInt("keys") != keys) {
+            wrong++;
+        }
+        delete loaded;
+    }
+    return (double)(micros() - start) / BOOTS;
+}
+
+void test_increment_benchmark(void) {
+    const int KEYS = 32;
+    const int ROUNDS = 150;
+    KvStore store;
+    store.begin();
+    store.set("keys", String(KEYS));
+
+    size_t peak = 0;
+    std::string peakLog;  //журнал перед самым компактированием
+    uint32_t compactions = 0;
+    unsigned long appendMu = 0;
+    unsigned long compactMu = 0;
+    for (int i = 0; i < KEYS * ROUNDS; i++) {
+        size_t before = store.logSize();
+        unsigned long start = micros();
+        store.increment(counterName(i % KEYS));
+        unsigned long took = micros() - start;
+        if (store.logSize() < before) {
+            compactions++;
+            compactMu += took;
+        } else {
+            appendMu += took;
+            if (peak < store.logSize()) {
+                peak = store.logSize();
+                peakLog = hostFiles().files[KV_STORE_FILE];
+            }
+        }
+    }
+    //журнал не остается больше порога: компактирует та запись, которая его перешла
+    TEST_ASSERT_GREATER_THAN(0, compactions);
+    TEST_ASSERT_TRUE(peak <= KV_COMPACT_SIZE);
+    TEST_ASSERT_TRUE(peak > KV_COMPACT_SIZE - 64);
+    for (int i = 0; i < KEYS; i++) {
+        TEST_ASSERT_EQUAL(ROUNDS, store.getInt(counterName(i)));
+    }
+
+    std::string compacted = hostFiles().files[KV_STORE_FILE];
+    hostFiles().files[KV_STORE_FILE] = peakLog;
+    int wrong = 0;
+    double bootFull = bootMu(KEYS, wrong);
+    hostFiles().files[KV_STORE_FILE] = compacted;
+    TEST_ASSERT_TRUE(store.compact());
+    size_t live = store.logSize();
+    double bootCompact = bootMu(KEYS, wrong);
+    TEST_ASSERT_EQUAL(0, wrong);
+    KvStore* loaded = reload();
+    TEST_ASSERT_EQUAL(ROUNDS, loaded->getInt(counterName(KEYS - 1)));
+    delete loaded;
+
+    char msg[200];
+    snprintf(msg, sizeof(msg), "%d keys, %d increments: %.1f us/increment, %.1f us with compaction (%u times)",
+             KEYS, KEYS * ROUNDS, (double)appendMu / (KEYS * ROUNDS - compactions),
+             compactions ? (double)compactMu / compactions : 0.0, (unsigned)compactions);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "boot: %.1f us on %u byte log before compaction, %.1f us on %u bytes after",
+             bootFull, (unsigned)peak, bootCompact, (unsigned)live);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_short_write_reported_and_recovered);
+    RUN_TEST(test_full_fs_keeps_old_log);
+    RUN_TEST(test_increment_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,75 @@
+/*
+* Прореживание LTTB: точек в ответе не больше запрошенного числа, края ряда сохраняются,
+* при 1 и 2 точках - последняя и края
+* pio test -e native -f test_lttb
+*/
+#include <unity.h>
+
+#include "../../src/Class/Lttb.cpp"
+
+static std::vector<RingLogRecord> series;
+
+static void source(RingLogHandler_t handler) {
+    for (size_t i = 0; i < series.size(); i++) {
+        handler(series[i]);
+    }
+}
+
+void setUp(void) {
+    series.clear();
+    for (uint32_t i = 0; i < 1000; i++) {
+        RingLogRecord rec = {1000 + i * 60, (float)((i * 37) % 101)};
+        series.push_back(rec);
+    }
+}
+
+void tearDown(void) {}
+
+void test_small_budgets(void) {
+    std::vector<RingLogRecord> out;
+    Lttb::downsample(source, 0, out);
+    TEST_ASSERT_EQUAL(0, out.size());
+
+    Lttb::downsample(source, 1, out);
+    TEST_ASSERT_EQUAL(1, out.size());
+    TEST_ASSERT_EQUAL(series.back().time, out[0].time);
+
+    Lttb::downsample(source, 2, out);
+    TEST_ASSERT_EQUAL(2, out.size());
+    TEST_ASSERT_EQUAL(series.front().time, out[0].time);
+    TEST_ASSERT_EQUAL(series.back().time, out[1].time);
+}
+
+void test_at_most_points(void) {
+    const size_t budgets[] = {3, 4, 10, 99, 500, 999, 1000, 2000};
+    std::vector<RingLogRecord> out;
+    for (size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++) {
+        size_t points = budgets[b];
+        Lttb::downsample(source, points, out);
+        size_t expected = points < series.size() ? points : series.size();
+        TEST_ASSERT_EQUAL(expected, out.size());
+        TEST_ASSERT_EQUAL(series.front().time, out.front().time);
+        TEST_ASSERT_EQUAL(series.back().time, out.back().time);
+        for (size_t i = 1; i < out.size(); i++) {
+            TEST_ASSERT_TRUE(out[i - 1].time < out[i].time);
+        }
+    }
+}
+
+//все точки с одним временем: делить по времени нечего, но и больше points не отдается
+void test_same_time(void) {
+    for (size_t i = 0; i < series.size(); i++) {
+        series[i].time = 5000;
+    }
+    std::vector<RingLogRecord> out;
+    Lttb::downsample(source, 10, out);
+    TEST_ASSERT_EQUAL(2, out.size());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_small_budgets);
+    RUN_TEST(test_at_most_points);
+    RUN_TEST(test_same_time);
+    return UNITY_END();
+}
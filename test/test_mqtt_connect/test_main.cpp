@@ -0,0 +1,155 @@
+/*
+* Недоступный брокер не задерживает loop: имя и TCP проверяются асинхронно,
+* PubSubClient подключается только к ответившему брокеру. Гистограммы длительности
+* прохода loop - прежний путь (connect() прямо из loop) и mqttLoop
+* pio test -e native -f test_mqtt_connect
+*/
+#include <unity.h>
+
+#include "../../src/Class/EventQueue.cpp"
+#include "../../src/Class/KeyTable.cpp"
+#include "../../src/Class/MqttLimiter.cpp"
+#include "../../src/Class/MqttOutbox.cpp"
+#include "../../src/Class/Settings.cpp"
+#include "../../src/Class/TopicTrie.cpp"
+#include "../../src/MqttClient.cpp"
+
+TickerScheduler ts(1);
+WiFiClient espClient;
+PubSubClient mqtt(espClient);
+String chipId = "test";
+String configSetupJson = "{}";
+static NotAsync notAsync(1);
+NotAsync* myNotAsyncActions = &notAsync;
+MqttSync mqttSync;
+
+TickerScheduler::TickerScheduler(uint8_t size) {}
+TickerScheduler::~TickerScheduler() {}
+bool TickerScheduler::add(uint8_t i, uint32_t period, tscallback_t, void*, boolean shouldFireNow) { return true; }
+bool TickerScheduler::remove(uint8_t i) { return true; }
+NotAsync::NotAsync(uint8_t size) {}
+NotAsync::~NotAsync() {}
+void NotAsync::add(uint8_t i, NotAsyncCb, void* arg) {}
+void MqttSync::start() {}
+void MqttSync::loop() {}
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+String jsonReadStr(String& json, String name) { return name == "mqttServer" ? "broker.local" : ""; }
+int jsonReadInt(String& json, String name) { return name == "mqttPort" ? 1883 : 0; }
+String jsonWriteBool(String& json, String name, boolean value) { return json; }
+const String readFile(const String& filename, size_t max_size) { return ""; }
+const String writeFile(const String& filename, const String& str) { return ""; }
+bool loopCmdAdd(const String& cmdStr, uint8_t source) { return true; }
+void loadScenario() {}
+void setLedStatus(LedStatus_t status) {}
+boolean isNetworkActive() { return true; }
+bool startAPMode() { return true; }
+
+static const unsigned long PASS_MS = 10;  //loop без нагрузки
+static const unsigned long OUTAGE_MS = 600000;  //10 минут без брокера
+static const unsigned long STALL_MS = 50;  //вместо таймаута TCP, чтобы тест шел быстро
+
+//прежний mqttLoop: попытка - connect() прямо из loop, пауза растет так же
+static void blockingLoop() {
+    static unsigned long retryAt = 0;
+    static uint32_t backoff = MQTT_BACKOFF_MIN_MS;
+    if ((long)(millis() - retryAt) >= 0 && !mqtt.connect(chipId.c_str())) {
+        retryAt = millis() + backoff;
+        backoff = backoff * 2 < MQTT_BACKOFF_MAX_MS ? backoff * 2 : MQTT_BACKOFF_MAX_MS;
+    }
+}
+
+static void run(LoopStats& stats, void (*loop)(), unsigned long duration) {
+    for (unsigned long t = 0; t < duration; t += PASS_MS) {
+        hostMillis() += PASS_MS;
+        stats.begin();
+        loop();
+        stats.end();
+    }
+}
+
+//пустые ячейки гистограммы пропускаются, последняя - все проходы длиннее
+static void report(const char* name, const LoopStats& stats) {
+    char buf[256];
+    int len = snprintf(buf, sizeof(buf), "%s: max %u ms, <1ms %u", name, stats._max_ms, stats._hist[0]);
+    for (uint8_t i = 1; i < LOOP_HIST_BUCKETS; i++) {
+        if (!stats._hist[i]) {
+            continue;
+        }
+        if (i < LOOP_HIST_BUCKETS - 1) {
+            len += snprintf(buf + len, sizeof(buf) - len, ", <%lums %u", 1UL << i, stats._hist[i]);
+        } else {
+            len += snprintf(buf + len, sizeof(buf) - len, ", >=%lums %u", 1UL << (i - 1), stats._hist[i]);
+        }
+    }
+    TEST_MESSAGE(buf);
+}
+
+void setUp(void) {
+    mqttReconnect();
+    mqttConfigured = true;
+    mqttInit();
+    mqtt.online = false;
+    mqtt.accepts = false;
+    mqtt.stallMs = STALL_MS;
+    mqtt.connects = 0;
+    AsyncClient::reachable = false;
+    AsyncClient::attempts = 0;
+}
+
+void tearDown(void) {}
+
+void test_unreachable_broker_does_not_stall_loop(void) {
+    LoopStats before;
+    run(before, blockingLoop, OUTAGE_MS);
+    size_t blockingAttempts = mqtt.connects;
+    report("connect() from loop", before);
+
+    mqtt.connects = 0;
+    LoopStats after;
+    run(after, mqttLoop, OUTAGE_MS);
+    report("mqttLoop", after);
+
+    TEST_ASSERT_GREATER_OR_EQUAL(STALL_MS, before._max_ms);
+    TEST_ASSERT_LESS_THAN(STALL_MS / 2, after._max_ms);
+    //PubSubClient к молчащему брокеру не подключается вовсе, попыток не больше, чем раньше
+    TEST_ASSERT_EQUAL(0, mqtt.connects);
+    TEST_ASSERT_GREATER_THAN(1, AsyncClient::attempts);
+    TEST_ASSERT_LESS_OR_EQUAL(blockingAttempts, AsyncClient::attempts);
+}
+
+void test_reachable_broker_connects(void) {
+    AsyncClient::reachable = true;
+    mqtt.accepts = true;
+    for (int i = 0; i < 3; i++) {
+        hostMillis() += PASS_MS;
+        mqttLoop();
+    }
+    TEST_ASSERT_EQUAL(1, AsyncClient::attempts);
+    TEST_ASSERT_EQUAL(1, mqtt.connects);
+    TEST_ASSERT_EQUAL(MS_CONNECTED, mqttState);
+    TEST_ASSERT_EQUAL(0x0100007f, (uint32_t)mqttServerIp);
+}
+
+//TCP принят, но брокер не ответил на CONNECT - следующая попытка по расписанию
+void test_rejected_connect_retries_later(void) {
+    AsyncClient::reachable = true;
+    mqtt.stallMs = 0;
+    for (int i = 0; i < 2; i++) {
+        hostMillis() += PASS_MS;
+        mqttLoop();
+    }
+    TEST_ASSERT_EQUAL(1, mqtt.connects);
+    TEST_ASSERT_EQUAL(MS_WAIT, mqttState);
+    hostMillis() += MQTT_BACKOFF_MIN_MS * 2;
+    mqttLoop();
+    TEST_ASSERT_EQUAL(2, AsyncClient::attempts);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unreachable_broker_does_not_stall_loop);
+    RUN_TEST(test_reachable_broker_connects);
+    RUN_TEST(test_rejected_connect_retries_later);
+    return UNITY_END();
+}
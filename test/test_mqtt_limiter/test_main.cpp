@@ -0,0 +1,83 @@
+/*
+* Лимитер mqtt на больших скоростях: уровень корзины не переполняется,
+* скорость выше MQTT_RATE_MAX работает как MQTT_RATE_MAX
+* pio test -e native -f test_mqtt_limiter
+*/
+#include <unity.h>
+
+#include "../../src/Class/EventQueue.cpp"
+#include "../../src/Class/KeyTable.cpp"
+#include "../../src/Class/MqttLimiter.cpp"
+#include "../../src/Class/MqttOutbox.cpp"
+#include "../../src/Class/Settings.cpp"
+#include "../../src/Class/TopicTrie.cpp"
+#include "../../src/MqttClient.cpp"
+
+TickerScheduler ts(1);
+WiFiClient espClient;
+PubSubClient mqtt(espClient);
+String chipId = "test";
+String configSetupJson = "{}";
+NotAsync* myNotAsyncActions = nullptr;
+MqttSync mqttSync;
+
+TickerScheduler::TickerScheduler(uint8_t size) {}
+TickerScheduler::~TickerScheduler() {}
+bool TickerScheduler::add(uint8_t i, uint32_t period, tscallback_t, void*, boolean shouldFireNow) { return true; }
+bool TickerScheduler::remove(uint8_t i) { return true; }
+void NotAsync::add(uint8_t i, NotAsyncCb, void* arg) {}
+void MqttSync::start() {}
+void MqttSync::loop() {}
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+String jsonReadStr(String& json, String name) { return ""; }
+int jsonReadInt(String& json, String name) { return 0; }
+String jsonWriteBool(String& json, String name, boolean value) { return json; }
+const String readFile(const String& filename, size_t max_size) { return ""; }
+const String writeFile(const String& filename, const String& str) { return ""; }
+bool loopCmdAdd(const String& cmdStr, uint8_t source) { return true; }
+void loadScenario() {}
+void setLedStatus(LedStatus_t status) {}
+boolean isNetworkActive() { return true; }
+bool startAPMode() { return true; }
+
+static uint32_t takeAll() {
+    uint32_t taken = 0;
+    while (taken < 1000000 && mqttLimiter.take(MC_STATUS)) {
+        taken++;
+    }
+    return taken;
+}
+
+//сколько токенов класса статуса можно взять подряд после опустошения и минуты простоя
+static uint32_t burstAfterIdle(unsigned long rate) {
+    mqttLimiter = MqttLimiter();
+    settings.mqttRate[MC_STATUS] = rate;
+    settings.mqttRate[MC_DEVICE] = MQTT_RATE_MAX;
+    takeAll();
+    hostMillis() += MQTT_RATE_UNIT;
+    return takeAll();
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_high_rates_do_not_overflow(void) {
+    const unsigned long rates[] = {600, 60000, 71583, 1000000};  //71583 * 60000 переполняет uint32_t почти до нуля
+    uint32_t expected[] = {600 * MQTT_RATE_BURST_S / 60, MQTT_RATE_MAX * MQTT_RATE_BURST_S / 60,
+                           MQTT_RATE_MAX * MQTT_RATE_BURST_S / 60, MQTT_RATE_MAX * MQTT_RATE_BURST_S / 60};
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        uint32_t taken = burstAfterIdle(rates[i]);
+        char msg[96];
+        snprintf(msg, sizeof(msg), "rate %lu/min: %u tokens after idle", rates[i], (unsigned)taken);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_EQUAL(expected[i], taken);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_high_rates_do_not_overflow);
+    return UNITY_END();
+}
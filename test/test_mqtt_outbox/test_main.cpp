@@ -0,0 +1,182 @@
+/*
+* Пропадание брокера: статусы и события копятся в памяти, сверх MQTT_OUTBOX_SIZE пишутся
+* в файл, после подключения отправляются по порядку без потерь и повторов,
+* в том числе если связь рвется посреди отправки и если устройство перезагрузилось
+* pio test -e native -f test_mqtt_outbox
+*/
+#include <unity.h>
+
+#include "../../src/Class/EventQueue.cpp"
+#include "../../src/Class/KeyTable.cpp"
+#include "../../src/Class/MqttLimiter.cpp"
+#include "../../src/Class/MqttOutbox.cpp"
+#include "../../src/Class/Settings.cpp"
+#include "../../src/Class/TopicTrie.cpp"
+#include "../../src/MqttClient.cpp"
+
+TickerScheduler ts(1);
+WiFiClient espClient;
+PubSubClient mqtt(espClient);
+String chipId = "test";
+String configSetupJson = "{}";
+NotAsync* myNotAsyncActions = nullptr;
+MqttSync mqttSync;
+
+TickerScheduler::TickerScheduler(uint8_t size) {}
+TickerScheduler::~TickerScheduler() {}
+bool TickerScheduler::add(uint8_t i, uint32_t period, tscallback_t, void*, boolean shouldFireNow) { return true; }
+bool TickerScheduler::remove(uint8_t i) { return true; }
+void NotAsync::add(uint8_t i, NotAsyncCb, void* arg) {}
+void MqttSync::start() {}
+void MqttSync::loop() {}
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+String jsonReadStr(String& json, String name) { return ""; }
+int jsonReadInt(String& json, String name) { return 0; }
+String jsonWriteBool(String& json, String name, boolean value) { return json; }
+const String readFile(const String& filename, size_t max_size) { return ""; }
+const String writeFile(const String& filename, const String& str) { return ""; }
+bool loopCmdAdd(const String& cmdStr, uint8_t source) { return true; }
+void loadScenario() {}
+void setLedStatus(LedStatus_t status) {}
+boolean isNetworkActive() { return true; }
+bool startAPMode() { return true; }
+
+static const int EVENTS = 100;
+
+static String eventTopic() {
+    return mqttRootDevice + "/door/event";
+}
+
+static void publishOutage() {
+    for (int i = 0; i < EVENTS; i++) {
+        TEST_ASSERT_TRUE(publishEvent("door", "open " + String(i)));
+        publishStatus("temp", String(20 + i));  //схлопывается до последнего значения
+    }
+}
+
+//отправка по мере пополнения лимита устройства, шаг - секунда
+static void drain(int seconds) {
+    for (int i = 0; i < seconds && !mqttOutbox.empty(); i++) {
+        hostMillis() += 1000;
+        mqttOutbox.loop();
+    }
+}
+
+//события дошли все, по одному разу и по порядку, статус - только последний
+static void checkDelivered(int events) {
+    int next = 0;
+    int statuses = 0;
+    for (size_t i = 0; i < mqtt.sent.size(); i++) {
+        const PubSubClient::Message& msg = mqtt.sent[i];
+        if (msg.topic == eventTopic().c_str()) {
+            TEST_ASSERT_EQUAL_STRING(("open " + String(next)).c_str(), msg.payload.c_str());
+            TEST_ASSERT_TRUE(msg.retain);
+            next++;
+        } else {
+            TEST_ASSERT_EQUAL_STRING((mqttRootDevice + "/temp/status").c_str(), msg.topic.c_str());
+            TEST_ASSERT_EQUAL_STRING(("{\"status\":\"" + String(20 + EVENTS - 1) + "\"}").c_str(), msg.payload.c_str());
+            statuses++;
+        }
+    }
+    TEST_ASSERT_EQUAL(events, next);
+    TEST_ASSERT_EQUAL(1, statuses);
+}
+
+void setUp(void) {
+    hostFiles().reset();
+    mqtt.online = false;
+    mqtt.record = true;
+    mqtt.sent.clear();
+    mqttRootDevice = "/IoTmanager/test";
+    mqttConfigured = true;
+    mqttOutbox = MqttOutbox();
+    hostMillis() += MQTT_RATE_UNIT;
+}
+
+void tearDown(void) {}
+
+void test_outage_replayed_in_order(void) {
+    publishOutage();
+    TEST_ASSERT_TRUE(FileFS.exists(MQTT_SPOOL_FILE));
+    TEST_ASSERT_GREATER_THAN(0, mqttOutbox._spilled);
+    TEST_ASSERT_EQUAL(0, mqttOutbox._dropped);
+    TEST_ASSERT_EQUAL(0, mqtt.sent.size());
+
+    mqtt.online = true;
+    drain(600);
+    TEST_ASSERT_TRUE(mqttOutbox.empty());
+    TEST_ASSERT_FALSE(FileFS.exists(MQTT_SPOOL_FILE));
+    checkDelivered(EVENTS);
+}
+
+void test_outage_during_replay(void) {
+    publishOutage();
+    mqtt.online = true;
+    drain(3);
+    size_t before = mqtt.sent.size();
+    TEST_ASSERT_GREATER_THAN(0, before);
+    TEST_ASSERT_FALSE(mqttOutbox.empty());
+
+    mqtt.online = false;  //связь снова пропала посреди отправки
+    drain(10);
+    TEST_ASSERT_EQUAL(before, mqtt.sent.size());
+    //новое событие встает в очередь за накопленными
+    TEST_ASSERT_TRUE(publishEvent("door", "open " + String(EVENTS)));
+
+    mqtt.online = true;
+    drain(600);
+    TEST_ASSERT_TRUE(mqttOutbox.empty());
+    checkDelivered(EVENTS + 1);
+}
+
+//после перезагрузки из файла отправляется то, что не успело уйти; память пропадает
+void test_spool_survives_restart(void) {
+    publishOutage();
+    size_t inRam = mqttOutbox.depth();
+    mqttOutbox = MqttOutbox();
+    mqttOutbox.begin();
+    TEST_ASSERT_GREATER_THAN(0, mqttOutbox.spoolSize());
+
+    mqtt.online = true;
+    drain(600);
+    TEST_ASSERT_TRUE(mqttOutbox.empty());
+    TEST_ASSERT_FALSE(FileFS.exists(MQTT_SPOOL_FILE));
+    int first = -1;
+    size_t events = 0;
+    for (size_t i = 0; i < mqtt.sent.size(); i++) {
+        if (mqtt.sent[i].topic == eventTopic().c_str()) {
+            int n = String(mqtt.sent[i].payload.c_str()).substring(5).toInt();
+            TEST_ASSERT_TRUE(first < 0 || n == first + (int)events);
+            if (first < 0) {
+                first = n;
+            }
+            events++;
+        }
+    }
+    TEST_ASSERT_EQUAL(EVENTS - first, events);
+    TEST_ASSERT_GREATER_OR_EQUAL(inRam - 1, first);  //в памяти были первые события и статус
+}
+
+//до первого подключения mqttServer еще пуст, но брокер в конфиге задан - сообщения копятся,
+//без брокера в конфиге копить некому
+void test_queued_before_first_connect(void) {
+    mqttServer = "";
+    TEST_ASSERT_TRUE(publishEvent("door", "open 0"));
+    TEST_ASSERT_TRUE(publishStatus("temp", "20"));
+    TEST_ASSERT_EQUAL(2, mqttOutbox.depth());
+
+    mqttConfigured = false;
+    TEST_ASSERT_FALSE(publishEvent("door", "open 1"));
+    TEST_ASSERT_FALSE(publishStatus("light", "1"));
+    TEST_ASSERT_EQUAL(2, mqttOutbox.depth());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_outage_replayed_in_order);
+    RUN_TEST(test_outage_during_replay);
+    RUN_TEST(test_spool_survives_restart);
+    RUN_TEST(test_queued_before_first_connect);
+    return UNITY_END();
+}
@@ -0,0 +1,125 @@
+/*
+* Публикация в mqtt без выделения памяти: топик и тело {"status":..} собираются
+* в статических буферах. Брокер-заглушка с record = false сам ничего не выделяет,
+* выделения считаются через operator new на каждый вызов publish*
+* pio test -e native -f test_mqtt_publish
+*/
+#include <unity.h>
+
+#include <new>
+
+#include "../../src/Class/EventQueue.cpp"
+#include "../../src/Class/KeyTable.cpp"
+#include "../../src/Class/MqttLimiter.cpp"
+#include "../../src/Class/MqttOutbox.cpp"
+#include "../../src/Class/Settings.cpp"
+#include "../../src/Class/TopicTrie.cpp"
+#include "../../src/MqttClient.cpp"
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+TickerScheduler ts(1);
+WiFiClient espClient;
+PubSubClient mqtt(espClient);
+String chipId = "test";
+String configSetupJson = "{}";
+NotAsync* myNotAsyncActions = nullptr;
+MqttSync mqttSync;
+
+TickerScheduler::TickerScheduler(uint8_t size) {}
+TickerScheduler::~TickerScheduler() {}
+bool TickerScheduler::add(uint8_t i, uint32_t period, tscallback_t, void*, boolean shouldFireNow) { return true; }
+bool TickerScheduler::remove(uint8_t i) { return true; }
+void NotAsync::add(uint8_t i, NotAsyncCb, void* arg) {}
+void MqttSync::start() {}
+void MqttSync::loop() {}
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+String jsonReadStr(String& json, String name) { return ""; }
+int jsonReadInt(String& json, String name) { return 0; }
+String jsonWriteBool(String& json, String name, boolean value) { return json; }
+const String readFile(const String& filename, size_t max_size) { return ""; }
+const String writeFile(const String& filename, const String& str) { return ""; }
+bool loopCmdAdd(const String& cmdStr, uint8_t source) { return true; }
+void loadScenario() {}
+void setLedStatus(LedStatus_t status) {}
+boolean isNetworkActive() { return true; }
+bool startAPMode() { return true; }
+
+static const int CALLS = 100;
+
+static size_t failed = 0;
+
+//перед каждым вызовом корзины лимитера успевают наполниться, ничего не откладывается
+template <typename F>
+static double allocationsPerCall(F publishOnce) {
+    publishOnce();  //первый вызов может завести статические буферы
+    size_t published = mqtt.published;
+    size_t before = allocations;
+    for (int i = 0; i < CALLS; i++) {
+        hostMillis() += MQTT_RATE_UNIT;
+        if (!publishOnce()) {
+            failed++;
+        }
+    }
+    failed += published + CALLS - mqtt.published;
+    return (double)(allocations - before) / CALLS;
+}
+
+void setUp(void) {
+    mqtt.online = true;
+    mqtt.record = false;
+    mqttRootDevice = "/IoTmanager/test";
+    mqttConfigured = true;
+}
+
+void tearDown(void) {}
+
+void test_publish_allocations(void) {
+    const String topic = "temperature";
+    const String value = "21.50";
+    const String key = "status";
+    const char chart[] = "{\"status\":[{\"x\":1600000000,\"y1\":21.50}]}";
+
+    double status = allocationsPerCall([&]() {
+        return publishStatus(topic, value);
+    });
+    double anyKey = allocationsPerCall([&]() {
+        return publishAnyJsonKey(topic, key, value);
+    });
+    double event = allocationsPerCall([&]() {
+        return publishEvent(topic, value);
+    });
+    double chartPoint = allocationsPerCall([&]() {
+        return publishChart(topic, chart, sizeof(chart) - 1);
+    });
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "allocations per call: status %.2f, json key %.2f, event %.2f, chart %.2f",
+             status, anyKey, event, chartPoint);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(0, failed);
+    TEST_ASSERT_TRUE(status == 0);
+    TEST_ASSERT_TRUE(anyKey == 0);
+    TEST_ASSERT_TRUE(event == 0);
+    TEST_ASSERT_TRUE(chartPoint == 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_publish_allocations);
+    return UNITY_END();
+}
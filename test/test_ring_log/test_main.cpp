@@ -0,0 +1,86 @@
+/*
+* Кольцевой журнал: при смене числа точек последние точки переносятся через короткий
+* временный файл, число точек больше заголовка урезается, а не переполняется
+* Обрыв питания в любом месте добавления на заполненном кольце не оставляет испорченной точки
+* pio test -e native -f test_ring_log
+*/
+#include <unity.h>
+
+#include "../../src/Class/RingLog.cpp"
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+
+void removeFile(const String& filename) {
+    FileFS.remove(filename);
+}
+
+void setUp(void) {
+    hostFiles().reset();
+}
+
+void tearDown(void) {}
+
+void test_resize_keeps_latest(void) {
+    const String path = "/logs/a-rather-long-sensor-key.bin";
+    {
+        RingLog log(path, 100);
+        for (uint32_t i = 0; i < 100; i++) {
+            TEST_ASSERT_TRUE(log.append(i, i * 0.5f));
+        }
+    }
+    RingLog log(path, 40);
+    TEST_ASSERT_EQUAL(40, log.capacity());
+    TEST_ASSERT_EQUAL(40, log.count());
+    uint32_t expected = 60;
+    log.forEach([&expected](const RingLogRecord& rec) {
+        TEST_ASSERT_EQUAL(expected, rec.time);
+        expected++;
+    });
+    TEST_ASSERT_EQUAL(100, expected);
+    TEST_ASSERT_FALSE(FileFS.exists(RING_LOG_TMP_FILE));
+    TEST_ASSERT_TRUE(strlen(RING_LOG_TMP_FILE) < 32);
+}
+
+void test_capacity_clamped(void) {
+    RingLog log("/logs/big.bin", 100000);
+    TEST_ASSERT_EQUAL(RING_LOG_MAX_CAPACITY, log.capacity());
+    RingLog reopened("/logs/big.bin", 100000);
+    TEST_ASSERT_EQUAL(RING_LOG_MAX_CAPACITY, reopened.capacity());
+}
+
+void test_torn_append_on_full_ring(void) {
+    const String path = "/logs/torn.bin";
+    const long writes = 2 * sizeof(RingLogHeader) + sizeof(RingLogRecord);
+    for (long budget = 0; budget <= writes; budget++) {
+        hostFiles().reset();
+        {
+            RingLog log(path, 10);
+            for (uint32_t i = 1; i <= 10; i++) {
+                log.append(i, i * 0.5f);
+            }
+            hostFiles().writeBudget = budget;  //питание пропадает после budget байт
+            log.append(100, 50.0f);
+            hostFiles().writeBudget = -1;
+        }
+        RingLog log(path, 10);
+        TEST_ASSERT_TRUE(log.count() >= 9);
+        uint32_t last = 0;
+        size_t broken = 0;
+        log.forEach([&last, &broken](const RingLogRecord& rec) {
+            bool valid = (rec.time <= 10 && rec.value == rec.time * 0.5f) || (rec.time == 100 && rec.value == 50.0f);
+            if (!valid || rec.time <= last) {
+                broken++;
+            }
+            last = rec.time;
+        });
+        TEST_ASSERT_EQUAL(0, broken);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_resize_keeps_latest);
+    RUN_TEST(test_capacity_clamped);
+    RUN_TEST(test_torn_append_on_full_ring);
+    return UNITY_END();
+}
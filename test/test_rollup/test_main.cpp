@@ -0,0 +1,75 @@
+/*
+* Прореживание лога: незаконченный интервал после перезагрузки досчитывается
+* из сырых точек начиная с resumeTime() и совпадает с тем, что было бы без перезагрузки
+* pio test -e native -f test_rollup
+*/
+#include <unity.h>
+
+#include "../../src/Class/RingLog.cpp"
+#include "../../src/Class/Rollup.cpp"
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+
+void removeFile(const String& filename) {
+    FileFS.remove(filename);
+}
+
+static std::vector<RollupRecord> readAll(RollupTier& tier) {
+    std::vector<RollupRecord> records;
+    tier.forEach([&records](const RollupRecord& rec) {
+        records.push_back(rec);
+    });
+    return records;
+}
+
+void setUp(void) {
+    hostFiles().reset();
+}
+
+void tearDown(void) {}
+
+void test_bucket_rebuilt_after_restart(void) {
+    RingLog raw("/logs/t.bin", 1000);
+    RollupTier reference("/logs/ref.5m", 100, 300);
+    {
+        RollupTier tier("/logs/t.5m", 100, 300);
+        for (uint32_t i = 0; i < 130; i++) {
+            uint32_t time = 1600000000 + i * 37;
+            float value = (i * 13) % 50;
+            raw.append(time, value);
+            tier.add(time, value);
+            reference.add(time, value);
+        }
+    }
+    RollupTier tier("/logs/t.5m", 100, 300);
+    uint32_t from = tier.resumeTime();
+    TEST_ASSERT_GREATER_THAN(0, from);
+    raw.forEach([&tier, from](const RingLogRecord& rec) {
+        if (rec.time >= from) {
+            tier.add(rec.time, rec.value);
+        }
+    });
+
+    std::vector<RollupRecord> expected = readAll(reference);
+    std::vector<RollupRecord> restored = readAll(tier);
+    TEST_ASSERT_EQUAL(expected.size(), restored.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        TEST_ASSERT_EQUAL(expected[i].time, restored[i].time);
+        TEST_ASSERT_EQUAL(expected[i].count, restored[i].count);
+        TEST_ASSERT_FLOAT_WITHIN(0.0001, expected[i].min, restored[i].min);
+        TEST_ASSERT_FLOAT_WITHIN(0.0001, expected[i].max, restored[i].max);
+        TEST_ASSERT_FLOAT_WITHIN(0.0001, expected[i].avg, restored[i].avg);
+    }
+}
+
+void test_empty_tier_takes_all_points(void) {
+    RollupTier tier("/logs/t.1h", 10, 3600);
+    TEST_ASSERT_EQUAL(0, tier.resumeTime());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bucket_rebuilt_after_restart);
+    RUN_TEST(test_empty_tier_takes_all_points);
+    return UNITY_END();
+}
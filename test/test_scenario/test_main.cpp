@@ -0,0 +1,242 @@
+/*
+* Разбор событий сценарием: старый проход по тексту сценария на каждое событие
+* против таблицы правил, собранной один раз в Scenario::load()
+* pio test -e native -f test_scenario
+*/
+#include <unity.h>
+
+#include <map>
+
+#include "../../src/Class/EventCoalescer.cpp"
+#include "../../src/Class/EventQueue.cpp"
+#include "../../src/Class/KeyTable.cpp"
+#include "../../src/Class/ScenarioClass3.cpp"
+#include "../../src/Utils/StringUtils.cpp"
+
+Settings settings;
+
+static std::map<std::string, String> values;
+static size_t executed = 0;
+
+String getValue(String& key) {
+    auto it = values.find(key.c_str());
+    return it == values.end() ? String("no value") : it->second;
+}
+
+void spaceCmdExecute(const String& cmdStr) {
+    executed++;
+}
+
+boolean publishEvent(const String& topic, const String& data) {
+    return true;
+}
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+
+//сценарий из RULES блоков, у каждого свой ключ, правило срабатывает на четные значения
+static String makeScenario(size_t rules) {
+    String text;
+    for (size_t i = 0; i < rules; i++) {
+        text += "key" + String((int)i) + " > limit+-" + String((int)(i % 3)) + "\n";
+        text += "rel" + String((int)i) + " 1\n";
+        text += "end\n";
+        text += "key" + String((int)i) + " = 2\n";
+        text += "rel" + String((int)i) + " 0\n";
+        text += "end\n";
+    }
+    return text;
+}
+
+//прежний разбор: текст сценария режется заново на каждое событие из eventBuf
+static String scenario;
+static String eventBuf;
+
+static void reparseLoop() {
+    String allBlocks = scenario;
+    allBlocks.replace("\r\n", "\n");
+    allBlocks.replace("\r", "\n");
+    allBlocks += "\n";
+
+    String incommingEvent = selectToMarker(eventBuf, ",");
+    String incommingEventKey = selectToMarker(incommingEvent, " ");
+    String incommingEventValue = selectToMarkerLast(incommingEvent, " ");
+
+    while (allBlocks.length() > 1) {
+        String oneBlock = selectToMarker(allBlocks, "end\n");
+        String condition = selectToMarker(oneBlock, "\n");
+        String setEventKey = selectFromMarkerToMarker(condition, " ", 0);
+        if (incommingEventKey == setEventKey) {
+            String setEventSign = selectFromMarkerToMarker(condition, " ", 1);
+            String setEventValue = selectFromMarkerToMarker(condition, " ", 2);
+            if (!isDigitDotCommaStr(setEventValue)) {
+                if (setEventValue.indexOf("+-") != -1) {
+                    String setEventValueName = selectToMarker(setEventValue, "+-");
+                    String gisteresisValue = selectToMarkerLast(setEventValue, "+-");
+                    String value = getValue(setEventValueName);
+                    if (setEventSign == ">") {
+                        setEventValue = String(value.toFloat() + gisteresisValue.toFloat());
+                    } else if (setEventSign == "<") {
+                        setEventValue = String(value.toFloat() - gisteresisValue.toFloat());
+                    }
+                } else {
+                    setEventValue = getValue(setEventValue);
+                }
+            }
+            bool flag = false;
+            if (setEventSign == "=") {
+                flag = incommingEventValue == setEventValue;
+            } else if (setEventSign == ">") {
+                flag = incommingEventValue.toFloat() > setEventValue.toFloat();
+            }
+            if (flag) {
+                oneBlock = deleteBeforeDelimiter(oneBlock, "\n");
+                oneBlock.replace("end", "");
+                spaceCmdExecute(oneBlock);
+            }
+        }
+        allBlocks = deleteBeforeDelimiter(allBlocks, "end\n");
+    }
+    eventBuf = deleteBeforeDelimiter(eventBuf, ",");
+}
+
+static const size_t EVENTS = 2000;
+
+static double bench(size_t rules, bool compiled) {
+    scenario = makeScenario(rules);
+    Scenario sc;
+    sc.load(scenario);
+    executed = 0;
+    unsigned long start = micros();
+    for (size_t i = 0; i < EVENTS; i++) {
+        String key = "key" + String((int)(i % rules));
+        String value = String((int)(i % 5));
+        if (compiled) {
+            eventQueue.push(key, value, ES_LOCAL);
+            sc.loop();
+        } else {
+            eventBuf = key + " " + value + ",";
+            reparseLoop();
+        }
+    }
+    return (double)(micros() - start) / EVENTS;
+}
+
+void setUp(void) {
+    settings.scen = true;
+    settings.loopBudgetMu = 1000000;
+    values["limit"] = "1";
+}
+
+void tearDown(void) {}
+
+void test_rules_match_reparse(void) {
+    for (size_t rules = 1; rules <= 20; rules++) {
+        scenario = makeScenario(rules);
+        Scenario sc;
+        sc.load(scenario);
+        TEST_ASSERT_EQUAL(rules * 2, sc.rulesCount());
+        for (int v = 0; v < 5; v++) {
+            String key = "key" + String((int)(rules - 1));
+            executed = 0;
+            eventBuf = key + " " + String(v) + ",";
+            reparseLoop();
+            size_t expected = executed;
+            executed = 0;
+            eventQueue.push(key, String(v), ES_LOCAL);
+            sc.loop();
+            TEST_ASSERT_EQUAL(expected, executed);
+        }
+    }
+}
+
+//ключей правил больше, чем было мест в прежней таблице на 64 ключа, ни одно правило не теряется
+void test_many_rule_keys(void) {
+    String text;
+    for (int i = 0; i < 200; i++) {
+        text += "many" + String(i) + " = 1\nrel 1\nend\n";
+    }
+    Scenario sc;
+    sc.load(text);
+    TEST_ASSERT_EQUAL(200, sc.rulesCount());
+
+    settings.evCoalesce = true;
+    size_t keys = keyTable.size();
+    executed = 0;
+    for (int i = 0; i < 200; i++) {
+        eventGen2("many" + String(i), "1", true);
+        eventGen2("norule" + String(i), "1", true);
+    }
+    sc.loop();
+    settings.evCoalesce = false;
+    TEST_ASSERT_EQUAL(200, executed);
+    TEST_ASSERT_EQUAL(keys, keyTable.size());
+    TEST_ASSERT_EQUAL(KEY_UNKNOWN, keyTable.find("norule1"));
+}
+
+//перезагрузка сценария с новыми именами ключей не исчерпывает таблицу,
+//ожидающее схлопнутое значение доходит до правила нового сценария
+void test_reload_rebuilds_keys(void) {
+    Scenario sc;
+    settings.evCoalesce = true;
+    for (int round = 0; round < 20; round++) {
+        String text;
+        for (int i = 0; i < 100; i++) {
+            text += "r" + String(round) + "_" + String(i) + " = 1\nrel 1\nend\n";
+        }
+        eventGen2("r" + String(round) + "_0", "1", true);  //ключа еще нет, уходит в общую очередь
+        sc.load(text);
+        TEST_ASSERT_EQUAL(100, sc.rulesCount());
+        TEST_ASSERT_EQUAL(100, keyTable.size());
+        executed = 0;
+        for (int i = 0; i < 100; i++) {
+            eventGen2("r" + String(round) + "_" + String(i), "1", true);
+        }
+        sc.loop();
+        TEST_ASSERT_EQUAL(101, executed);
+    }
+    eventGen2("r19_5", "1", true);
+    sc.load("r19_5 = 1\nrel 1\nend\n");
+    executed = 0;
+    sc.loop();
+    settings.evCoalesce = false;
+    TEST_ASSERT_EQUAL(1, executed);
+}
+
+//схлопываются только значения датчиков, нажатия кнопки доходят все
+void test_coalesce_sensor_only(void) {
+    Scenario sc;
+    sc.load("btn = 1\nrel 1\nend\nbtn = 0\nrel 0\nend\ntemp > 20\nfan 1\nend\n");
+    settings.evCoalesce = true;
+    executed = 0;
+    eventGen2("btn", "1");
+    eventGen2("btn", "0");
+    eventGen2("btn", "1");
+    eventGen2("temp", "25", true);
+    eventGen2("temp", "19", true);
+    sc.loop();
+    settings.evCoalesce = false;
+    TEST_ASSERT_EQUAL(3, executed);
+}
+
+void test_dispatch_benchmark(void) {
+    const size_t sizes[] = {5, 20, 50};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        double reparse = bench(sizes[i], false);
+        double compiled = bench(sizes[i], true);
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%u blocks: reparse %.2f us/event, rule table %.2f us/event",
+                 (unsigned)(sizes[i] * 2), reparse, compiled);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE(compiled < reparse);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rules_match_reparse);
+    RUN_TEST(test_many_rule_keys);
+    RUN_TEST(test_reload_rebuilds_keys);
+    RUN_TEST(test_coalesce_sensor_only);
+    RUN_TEST(test_dispatch_benchmark);
+    return UNITY_END();
+}
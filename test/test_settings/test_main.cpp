@@ -0,0 +1,70 @@
+/*
+* Настройки: setBool() из веб задачи только отмечает изменение,
+* обработчики вызываются из loop по одному разу на настройку
+* pio test -e native -f test_settings
+*/
+#include <unity.h>
+
+#include <thread>
+
+#include "../../src/Class/Settings.cpp"
+
+String configSetupJson = "{}";
+
+void SerialPrint(String errorLevel, String module, String msg) {}
+
+String jsonWriteBool(String& json, String name, boolean value) {
+    return json;
+}
+
+static std::vector<String> calls;
+
+void setUp(void) {
+    calls.clear();
+}
+
+void tearDown(void) {}
+
+void test_handlers_run_from_loop(void) {
+    static bool registered = false;
+    if (!registered) {
+        settings.onChange([](const String& name) {
+            calls.push_back(name);
+        });
+        registered = true;
+    }
+    std::thread web([]() {
+        settings.setBool("scen", true);
+        settings.setBool("MqttIn", true);
+        settings.setBool("scen", false);
+        settings.setBool("scen", true);
+    });
+    web.join();
+    TEST_ASSERT_TRUE(settings.scen);
+    TEST_ASSERT_TRUE(settings.mqttIn);
+    TEST_ASSERT_EQUAL(0, calls.size());
+
+    settings.loop();
+    TEST_ASSERT_EQUAL(2, calls.size());
+    TEST_ASSERT_EQUAL_STRING("scen", calls[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("MqttIn", calls[1].c_str());
+
+    settings.loop();
+    TEST_ASSERT_EQUAL(2, calls.size());
+}
+
+void test_changed_without_new_value(void) {
+    settings.setBool("uart", settings.uart);
+    settings.loop();
+    TEST_ASSERT_EQUAL(0, calls.size());
+    settings.changed("scen");
+    settings.loop();
+    TEST_ASSERT_EQUAL(1, calls.size());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_handlers_run_from_loop);
+    RUN_TEST(test_changed_without_new_value);
+    return UNITY_END();
+}
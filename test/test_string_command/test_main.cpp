@@ -0,0 +1,127 @@
+/*
+* Поиск команды в словаре StringCommand: хэш-индекс против прежнего перебора strncmp
+* на 10, 100 и 500 зарегистрированных командах
+* pio test -e native -f test_string_command
+*/
+#include <unity.h>
+
+#include "../../lib/ESP8266-StringCommand/StringCommand.cpp"
+
+static StringCommand* cmd;
+static String lastOrder;
+static String lastArg;
+static size_t handled = 0;
+static size_t unknown = 0;
+
+static void handler() {
+    lastOrder = cmd->order();
+    lastArg = cmd->next();
+    handled++;
+}
+
+static void defaultHandler(const char* command) {
+    unknown++;
+}
+
+static String commandName(int i) {
+    return "cmd-" + String(i);
+}
+
+//прежний словарь: массив, поиск перебором
+struct LinearEntry {
+    char command[SERIALCOMMAND_MAXCOMMANDLENGTH + 1];
+    void (*function)();
+};
+static std::vector<LinearEntry> linear;
+
+static void linearDispatch(const char* line) {
+    char buf[SERIALCOMMAND_BUFFER];
+    strlcpy(buf, line, sizeof(buf));
+    char* last;
+    char* command = strtok_r(buf, " ", &last);
+    for (size_t i = 0; i < linear.size(); i++) {
+        if (strncmp(command, linear[i].command, SERIALCOMMAND_MAXCOMMANDLENGTH) == 0) {
+            handled++;
+            return;
+        }
+    }
+    unknown++;
+}
+
+static void fill(int commands) {
+    delete cmd;
+    cmd = new StringCommand();
+    cmd->setDefaultHandler(defaultHandler);
+    linear.clear();
+    for (int i = 0; i < commands; i++) {
+        String name = commandName(i);
+        cmd->addCommand(name.c_str(), handler);
+        LinearEntry entry;
+        strncpy(entry.command, name.c_str(), SERIALCOMMAND_MAXCOMMANDLENGTH);
+        entry.command[SERIALCOMMAND_MAXCOMMANDLENGTH] = 0;
+        entry.function = handler;
+        linear.push_back(entry);
+    }
+}
+
+void setUp(void) {
+    handled = 0;
+    unknown = 0;
+}
+
+void tearDown(void) {}
+
+void test_dispatch_finds_every_command(void) {
+    fill(500);
+    for (int i = 0; i < 500; i++) {
+        String line = commandName(i) + " " + String(i * 3);
+        cmd->readStr(line);
+        TEST_ASSERT_EQUAL_STRING(commandName(i).c_str(), lastOrder.c_str());
+        TEST_ASSERT_EQUAL_STRING(String(i * 3).c_str(), lastArg.c_str());
+    }
+    cmd->readStr("missing 1");
+    TEST_ASSERT_EQUAL(500, handled);
+    TEST_ASSERT_EQUAL(1, unknown);
+}
+
+void test_dispatch_benchmark(void) {
+    const int sizes[] = {10, 100, 500};
+    const int CALLS = 20000;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int commands = sizes[s];
+        fill(commands);
+        std::vector<String> lines;
+        for (int i = 0; i < 256; i++) {
+            lines.push_back(commandName((i * 7919) % commands) + " 1 2");
+        }
+
+        unsigned long start = micros();
+        for (int i = 0; i < CALLS; i++) {
+            linearDispatch(lines[i & 255].c_str());
+        }
+        double linearUs = (double)(micros() - start) * 1000 / CALLS;
+
+        start = micros();
+        for (int i = 0; i < CALLS; i++) {
+            cmd->readStr(lines[i & 255]);
+        }
+        double hashUs = (double)(micros() - start) * 1000 / CALLS;
+
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d commands: linear %.0f ns/call, hash index %.0f ns/call", commands, linearUs, hashUs);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_EQUAL(2 * CALLS, handled);
+        TEST_ASSERT_EQUAL(0, unknown);
+        handled = 0;
+        if (commands >= 100) {
+            TEST_ASSERT_TRUE(hashUs < linearUs);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_dispatch_finds_every_command);
+    RUN_TEST(test_dispatch_benchmark);
+    return UNITY_END();
+}
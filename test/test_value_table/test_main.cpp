@@ -0,0 +1,166 @@
+/*
+* Таблица значений: запись и чтение на 50+ ключах против прежней json строки,
+* которая разбиралась и собиралась заново на каждое обращение
+* Снимок для веба: запросы из другой задачи идут одновременно с записью в loop,
+* собирается только по запросу
+* pio test -e native -f test_value_table
+*/
+#include <unity.h>
+
+#include <atomic>
+#include <thread>
+
+#include "../../src/Class/ItemScheduler.cpp"
+#include "../../src/Class/ValueTable.cpp"
+#include "../../src/Class/WebSnapshot.cpp"
+
+String getQueueStatsJson(const String& json) {
+    return json;
+}
+
+static String keyName(int i) {
+    return "sensor" + String(i);
+}
+
+//прежнее хранение: configLiveJson и jsonWriteStr/jsonReadStr
+static String oldJsonWrite(String& json, const String& name, const String& value) {
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.parseObject(json);
+    root[name] = value;
+    json = "";
+    root.printTo(json);
+    return json;
+}
+
+static String oldJsonRead(String& json, const String& name) {
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject& root = jsonBuffer.parseObject(json);
+    return root[name].as<String>();
+}
+
+void setUp(void) {
+    liveValues.clear();
+    storeValues.clear();
+}
+
+void tearDown(void) {}
+
+void test_values_round_trip(void) {
+    for (int i = 0; i < 64; i++) {
+        liveValues.setFloat(keyName(i), i * 1.5f);
+    }
+    liveValues.setInt("count", 7);
+    liveValues.setStr("state", "on");
+    for (int i = 0; i < 64; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.001, i * 1.5f, liveValues.getFloat(keyName(i)));
+    }
+    TEST_ASSERT_EQUAL(7, liveValues.getInt("count"));
+    TEST_ASSERT_EQUAL_STRING("on", liveValues.getStr("state").c_str());
+    TEST_ASSERT_EQUAL(66, liveValues.size());
+}
+
+void test_throughput_benchmark(void) {
+    const int sizes[] = {50, 100, 200};
+    const int OPS = 20000;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int keys = sizes[s];
+        std::vector<String> names;
+        for (int i = 0; i < keys; i++) {
+            names.push_back(keyName(i));
+        }
+        liveValues.clear();
+        String json = "{}";
+        for (int i = 0; i < keys; i++) {
+            liveValues.setFloat(names[i], 0);
+            oldJsonWrite(json, names[i], "0.00");
+        }
+
+        unsigned long start = micros();
+        for (int i = 0; i < OPS; i++) {
+            liveValues.setFloat(names[i % keys], i * 0.25f);
+        }
+        double tableWrite = (double)(micros() - start) * 1000 / OPS;
+        start = micros();
+        size_t len = 0;
+        for (int i = 0; i < OPS; i++) {
+            len += liveValues.getStr(names[i % keys]).length();
+        }
+        double tableRead = (double)(micros() - start) * 1000 / OPS;
+
+        const int JSON_OPS = OPS / 20;
+        start = micros();
+        for (int i = 0; i < JSON_OPS; i++) {
+            oldJsonWrite(json, names[i % keys], String(i * 0.25f));
+        }
+        double jsonWrite = (double)(micros() - start) * 1000 / JSON_OPS;
+        start = micros();
+        for (int i = 0; i < JSON_OPS; i++) {
+            len += oldJsonRead(json, names[i % keys]).length();
+        }
+        double jsonRead = (double)(micros() - start) * 1000 / JSON_OPS;
+
+        char msg[160];
+        snprintf(msg, sizeof(msg), "%d keys: table write %.0f ns, read %.0f ns; json string write %.0f ns, read %.0f ns",
+                 keys, tableWrite, tableRead, jsonWrite, jsonRead);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_GREATER_THAN(0, len);
+    }
+}
+
+//веб задача только копирует готовый снимок, таблицу в это время меняет loop
+void test_snapshot_concurrent_reads(void) {
+    std::atomic<bool> stop(false);
+    std::atomic<bool> valid(true);
+    std::atomic<size_t> reads(0);
+    std::thread web([&]() {
+        while (!stop) {
+            uint32_t build = storeSnapshot.want();
+            String json;
+            while (!storeSnapshot.get(build, json) && !stop) {
+                std::this_thread::yield();
+            }
+            if (!json.startsWith("{") || !json.endsWith("}")) {
+                valid = false;
+            }
+            reads++;
+        }
+    });
+    for (int i = 0; i < 20000 || reads < 1000; i++) {
+        storeValues.setInt(keyName(i % 80), i);  //новые ключи перекладывают вектор записей
+        hostMillis() += 1;
+        webSnapshotsLoop();
+    }
+    stop = true;
+    web.join();
+    TEST_ASSERT_TRUE(valid);
+    TEST_ASSERT_GREATER_OR_EQUAL(1000, reads.load());
+}
+
+//без запросов снимок не собирается, устаревший отдается только после пересборки
+void test_snapshot_built_on_request(void) {
+    hostMillis() += WEB_SNAPSHOT_MIN_MS;
+    webSnapshotsLoop();
+    storeValues.setInt("lazy", 1);
+    uint32_t build = storeSnapshot.want();
+    String json;
+    TEST_ASSERT_FALSE(storeSnapshot.get(build, json));
+    webSnapshotsLoop();
+    TEST_ASSERT_TRUE(storeSnapshot.get(build, json));
+
+    TEST_ASSERT_EQUAL(build, storeSnapshot.want());  //моложе WEB_SNAPSHOT_MIN_MS - отдается готовый
+    for (int i = 0; i < 100; i++) {
+        storeValues.setInt("lazy", i);
+        hostMillis() += WEB_SNAPSHOT_MIN_MS;
+        webSnapshotsLoop();
+    }
+    TEST_ASSERT_EQUAL(build + 1, storeSnapshot.want());  //за это время ни одной сборки
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_values_round_trip);
+    RUN_TEST(test_throughput_benchmark);
+    RUN_TEST(test_snapshot_concurrent_reads);
+    RUN_TEST(test_snapshot_built_on_request);
+    return UNITY_END();
+}